@@ -0,0 +1,985 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <cstdint>
+#include <atomic>
+#include <filesystem>
+#include "keyword_bst.h"
+#include "versioned_bst.h"
+#include "radix_tree.h"
+#include "huffman.h"
+#include "keyword_analysis.h"
+#include "csv_scanner.h"
+#include "keyword_table_file.h"
+#include "synthetic_data.h"
+using namespace std;
+
+// 性能测试：用确定性的合成数据依次测试CSV读取与统计、关键词BST、哈夫曼编码。
+// benchmark [专利行数] [结果CSV路径]：默认20万行；指定结果路径时把各项指标写成 name,value,unit，便于前后版本对比
+
+// 一项测试指标
+struct BenchResult {
+    string name;
+    double value;
+    string unit;
+};
+
+vector<BenchResult> results;
+
+void report(const string& name, double value, const string& unit, const string& note = "") {
+    results.push_back({name, value, unit});
+    cout << "  " << name << ": " << value << " " << unit;
+    if (!note.empty()) cout << "（" << note << "）";
+    cout << endl;
+}
+
+template <class F>
+double elapsedMs(F f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+}
+
+// 丢弃所有输出的流缓冲，用于测量遍历、区间查询等函数本身的开销
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+// 测量期间把cout重定向到NullBuffer
+template <class F>
+double elapsedMsSilenced(F f) {
+    NullBuffer nullBuffer;
+    streambuf* saved = cout.rdbuf(&nullBuffer);
+    double ms = elapsedMs(f);
+    cout.rdbuf(saved);
+    return ms;
+}
+
+// 按glibc malloc的块大小估算一次分配实际占用的字节数（8字节块头，16字节对齐，最小32字节）
+size_t mallocChunkBytes(size_t size) {
+    return max<size_t>(32, (size + 8 + 15) / 16 * 16);
+}
+
+// 每个关键词的内存占用：逐个new、节点内含std::string的旧布局 vs 节点池+字符串区
+void printMemoryReport(const vector<KeywordRow>& rows) {
+    struct LegacyTreeNode {
+        string keyword;
+        int freq;
+        double avg_novelty;
+        LegacyTreeNode *left, *right;
+    };
+
+    size_t legacyBytes = 0;
+    for (const KeywordRow& row : rows) {
+        legacyBytes += mallocChunkBytes(sizeof(LegacyTreeNode));
+        if (row.keyword.length() >= sizeof(string) - 16) {  // 超出短字符串优化(SSO)容量时另占一块堆内存
+            legacyBytes += mallocChunkBytes(row.keyword.length() + 1);
+        }
+    }
+    size_t pooledBytes = nodePool.nodeBytesReserved() + nodePool.keywordArena().bytesReserved();
+    size_t n = max<size_t>(1, nodePool.nodeCount());
+
+    report("旧布局内存（估算）", (double)legacyBytes / rows.size(), "bytes/关键词");
+    report("节点池+字符串区内存", (double)pooledBytes / n, "bytes/关键词");
+}
+
+// 全表扫描统计满足筛选条件的关键词数（与filterByNoveltyAndFreq相同的遍历，只是不输出）
+size_t scanByNoveltyAndFreq(TreeNode* root, double minNovelty, int minFreq) {
+    size_t count = 0;
+    vector<TreeNode*> stack;
+    if (root != nullptr) stack.push_back(root);
+    while (!stack.empty()) {
+        TreeNode* node = stack.back();
+        stack.pop_back();
+        if (node->avg_novelty >= minNovelty && node->freq >= minFreq) count++;
+        if (node->left != nullptr) stack.push_back(node->left);
+        if (node->right != nullptr) stack.push_back(node->right);
+    }
+    return count;
+}
+
+// ========== CSV读取与统计 ==========
+
+// 两张统计表的关键词集合相同，且每个关键词的频次和Novelty总和逐位相等
+bool sameKeywordStats(const KeywordTable& a, const KeywordTable& b) {
+    if (a.size() != b.size()) return false;
+    for (uint32_t id = 0; id < a.size(); id++) {
+        uint32_t other = b.find(a.keywordAt(id));
+        if (other == KeywordTable::NOT_FOUND || b.stats(other).freq != a.stats(id).freq ||
+            b.stats(other).noveltySum != a.stats(id).noveltySum) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 按experiment_3_analysis的增量模式走一遍：检查点可用时接着统计，否则从头统计
+AnalysisCheckpoint runWithCheckpoint(string_view body, const string& checkpointPath) {
+    AnalysisCheckpoint state;
+    size_t start = 0;
+    if (loadCheckpoint(checkpointPath, state)) {
+        if (canResumeFrom(state, body)) {
+            start = state.inputOffset;
+        } else {
+            state = AnalysisCheckpoint();
+        }
+    }
+    state.lineCount += aggregateSequential(body.substr(start), state.table);
+    return state;
+}
+
+// 返回统计得到的关键词表（freq >= 4，按关键词排序），供后面的BST和哈夫曼测试使用
+vector<KeywordRow> benchmarkAnalysis(const string& csv) {
+    cout << "\n【CSV读取与统计】" << endl;
+    double megabytes = csv.size() / 1048576.0;
+
+    string_view data = csv;
+    size_t bodyStart = 0;
+    nextLine(data, bodyStart);
+    string_view body = data.substr(bodyStart);
+
+    size_t keywordCount = 0;
+    double parseMs = elapsedMs([&] {
+        vector<string_view> fields, keywords;
+        size_t pos = 0;
+        while (pos < body.length()) {
+            double novelty;
+            if (parseRecord(nextLine(body, pos), fields, keywords, novelty)) keywordCount += keywords.size();
+        }
+    });
+    report("逐行解析", megabytes / (parseMs / 1000), "MB/s", to_string(keywordCount) + " 个关键词");
+
+    // 向量化结构扫描：逐字节掩码与SSE2/AVX2掩码走同样的第二遍，关键词必须与逐行解析逐个相同
+    for (ScanPath path : {ScanPath::SCALAR, ScanPath::SSE2, ScanPath::AVX2}) {
+        if (!scanPathSupported(path)) continue;
+        size_t scanCount = 0;
+        double scanMs = elapsedMs([&] {
+            vector<string_view> fields, keywords;
+            CSVScanner scanner(body, path);
+            while (!scanner.done()) {
+                double novelty;
+                if (scanner.nextRecord(fields, keywords, novelty)) scanCount += keywords.size();
+            }
+        });
+        bool same = scanCount == keywordCount;
+        vector<string_view> fields, keywords, expected;
+        CSVScanner scanner(body, path);
+        size_t pos = 0;
+        while (same && pos < body.length()) {
+            double novelty, expectedNovelty = 0;
+            bool expectedValid = parseRecord(nextLine(body, pos), fields, expected, expectedNovelty);
+            bool valid = scanner.nextRecord(fields, keywords, novelty);
+            same = valid == expectedValid && (!valid || (keywords == expected && novelty == expectedNovelty));
+        }
+        report(string("向量化扫描（") + scanPathName(path) + "）", csv.size() / 1e9 / (scanMs / 1000), "GB/s",
+               same ? "与逐行解析结果相同" : "结果不一致！");
+    }
+
+    KeywordTable sequential;
+    int lineCount = 0;
+    double sequentialMs = elapsedMs([&] { lineCount = aggregateSequential(body, sequential); });
+    report("单线程统计", megabytes / (sequentialMs / 1000), "MB/s", to_string(lineCount) + " 行");
+
+    // 多线程统计随线程数的扩展：合并时按原始顺序重放Novelty是串行的，单独计时看它占多大比例
+    vector<unsigned> threadCounts = {1, 2, 4};
+    if (thread::hardware_concurrency() > 4) threadCounts.push_back(thread::hardware_concurrency());
+    for (unsigned threadCount : threadCounts) {
+        KeywordTable parallel;
+        double parallelMs = elapsedMs([&] { aggregateParallel(body, threadCount, parallel); });
+
+        vector<string_view> shards = splitShards(body, threadCount);
+        vector<ShardResult> shardResults(shards.size());
+        for (size_t i = 0; i < shards.size(); i++) aggregateShard(shards[i], shardResults[i]);
+        KeywordTable merged;
+        double mergeMs = elapsedMs([&] { mergeShards(shardResults, merged); });
+
+        bool same = sameKeywordStats(parallel, sequential);
+        ostringstream note;
+        note << "串行合并 " << mergeMs << " ms，占 " << 100 * mergeMs / parallelMs << "%" << (same ? "" : "，结果不一致！");
+        report("多线程统计（" + to_string(threadCount) + " 个线程）", megabytes / (parallelMs / 1000), "MB/s", note.str());
+    }
+
+    // 增量统计：前99%的行已在检查点中，只统计追加的最后1%，再与上一次的统计表比较出变化
+    size_t split = body.find('\n', body.length() / 100 * 99);
+    split = split == string_view::npos ? body.length() : split + 1;
+    KeywordTable previous;
+    aggregateSequential(body.substr(0, split), previous);
+    KeywordTable incremental = previous;
+    int changeCount = 0;
+    double incrementalMs = elapsedMs([&] {
+        aggregateSequential(body.substr(split), incremental);
+        NullBuffer nullBuffer;
+        ostream deltaOut(&nullBuffer);
+        changeCount = writeKeywordDelta(deltaOut, previous, incremental, 4);
+    });
+    report("增量统计（追加1%）", incrementalMs, "ms",
+           to_string(changeCount) + " 个关键词有变化，完整统计 " + to_string((int)sequentialMs) + " ms");
+
+    // 检查点截断在文件头、条目中间等位置时读取失败，不能留下一半的状态：结果必须与从头统计相同
+    string checkpointPath = (filesystem::temp_directory_path() / "benchmark_checkpoint.bin").string();
+    AnalysisCheckpoint saved;
+    saved.inputOffset = split;
+    saved.boundaryHash = boundaryHash(body, split);
+    saved.lineCount = aggregateSequential(body.substr(0, split), saved.table);
+    bool recovered = saveCheckpoint(checkpointPath, saved);
+    uintmax_t checkpointBytes = recovered ? filesystem::file_size(checkpointPath) : 0;
+    for (uintmax_t cut : {checkpointBytes, (uintmax_t)10, (uintmax_t)28, checkpointBytes / 2, checkpointBytes - 1}) {
+        recovered = recovered && saveCheckpoint(checkpointPath, saved);
+        if (cut < checkpointBytes) filesystem::resize_file(checkpointPath, cut);
+        AnalysisCheckpoint state = runWithCheckpoint(body, checkpointPath);
+        recovered = recovered && state.lineCount == lineCount && sameKeywordStats(state.table, sequential);
+    }
+    filesystem::remove(checkpointPath);
+    report("截断的检查点", recovered ? 1 : 0, "", recovered ? "完整与截断的检查点结果都与从头统计相同" : "结果不一致！");
+
+    vector<KeywordRow> rows;
+    double outputMs = elapsedMs([&] {
+        for (uint32_t id : sequential.sortedIds()) {
+            const KeywordStats& stats = sequential.stats(id);
+            if (stats.freq >= 4) {
+                rows.push_back({string(sequential.keywordAt(id)), stats.freq, stats.noveltySum / stats.freq});
+            }
+        }
+    });
+    report("排序并输出统计表", outputMs, "ms", to_string(rows.size()) + " 个频次>=4的关键词");
+    return rows;
+}
+
+// ========== 启动加载：文本CSV与二进制统计表 ==========
+
+// 对.kwtb文件的一处改动：在position处按小端序写入bytes个字节
+struct TableEdit {
+    size_t position;
+    uint64_t value;
+    int bytes;
+};
+
+// 把tablePath复制一份并做edits中的改动，不核对校验和打开，返回是否被拒绝
+bool rejectsCorruptTable(const string& tablePath, const vector<TableEdit>& edits) {
+    ifstream in(tablePath, ios::binary);
+    string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    for (const TableEdit& edit : edits) {
+        for (int i = 0; i < edit.bytes && edit.position + i < content.size(); i++) {
+            content[edit.position + i] = (char)((edit.value >> (8 * i)) & 0xFF);
+        }
+    }
+    string corruptPath = tablePath + ".corrupt";
+    ofstream(corruptPath, ios::binary).write(content.data(), content.size());
+    KeywordTableFile table;
+    bool rejected = !table.open(corruptPath, false);
+    table.close();
+    filesystem::remove(corruptPath);
+    return rejected;
+}
+
+void benchmarkTableLoading(const vector<KeywordRow>& rows) {
+    cout << "\n【启动加载（文本CSV vs 二进制统计表）】" << endl;
+    filesystem::path directory = filesystem::temp_directory_path();
+    string csvPath = (directory / "benchmark_keywords.csv").string();
+    string tablePath = (directory / "benchmark_keywords.kwtb").string();
+
+    ofstream csvFile(csvPath);
+    csvFile << "keyword,freq,avg_novelty" << endl;
+    vector<string_view> keywords;
+    vector<int> freqs;
+    vector<double> novelties;
+    for (const KeywordRow& row : rows) {
+        csvFile << row.keyword << "," << row.freq << "," << row.avg_novelty << "\n";
+        keywords.push_back(row.keyword);
+        freqs.push_back(row.freq);
+        novelties.push_back(row.avg_novelty);
+    }
+    csvFile.close();
+    if (!writeKeywordTableFile(tablePath, keywords, freqs, novelties)) {
+        cerr << "无法写入二进制统计表: " << tablePath << endl;
+        return;
+    }
+
+    // BST：读入并建树
+    double csvTreeMs = elapsedMs([&] {
+        vector<KeywordRow> loaded;
+        readKeywordCSV(csvPath, loaded);
+        root = bulkLoad(loaded);
+    });
+    size_t csvNodes = nodePool.nodeCount();
+    clearTree();
+    root = nullptr;
+    double tableTreeMs = elapsedMs([&] {
+        KeywordTableFile table;
+        table.open(tablePath);
+        root = bulkLoad(table);
+    });
+    string treeNote = nodePool.nodeCount() == csvNodes ? "" : "关键词数不一致！";
+    clearTree();
+    root = nullptr;
+    report("BST启动（CSV）", csvTreeMs, "ms", treeNote);
+    report("BST启动（.kwtb）", tableTreeMs, "ms", treeNote);
+
+    // 哈夫曼：读入关键词与频率
+    vector<string> csvKeywords, tableKeywords;
+    vector<int> csvFreqs, tableFreqs;
+    vector<double> csvNovelties, tableNovelties;
+    double csvReadMs = elapsedMs([&] { readCSV(csvPath, csvKeywords, csvFreqs, csvNovelties); });
+    double tableReadMs = elapsedMs([&] { readKeywordTable(tablePath, tableKeywords, tableFreqs, tableNovelties); });
+    string readNote = csvKeywords == tableKeywords && csvFreqs == tableFreqs ? "" : "结果不一致！";
+    report("哈夫曼读入（CSV）", csvReadMs, "ms", readNote);
+    report("哈夫曼读入（.kwtb）", tableReadMs, "ms", readNote);
+
+    // 只映射并校验，不建任何结构
+    KeywordTableFile table;
+    report("映射并校验.kwtb", elapsedMs([&] { table.open(tablePath); }), "ms");
+    report("映射.kwtb（不核对校验和）", elapsedMs([&] { table.open(tablePath, false); }), "ms");
+    table.close();
+
+    // 篡改过的文件头与偏移列：各列位置越界、在uint64中回绕、偏移递减都必须在打开时拒绝，
+    // 即使不核对校验和也不会让各列指针越过映射的范围
+    uint64_t fileBytes = filesystem::file_size(tablePath);
+    uint64_t n = keywords.size();
+    // 只有一个关键词的表：新颖度列位置改为2^64-8，加上8n后字符串区位置回绕成0，整个文件都成了这个关键词
+    string oneKeywordPath = (directory / "benchmark_one.kwtb").string();
+    bool rejected = n >= 2 && writeKeywordTableFile(oneKeywordPath, {keywords[0]}, {freqs[0]}, {novelties[0]});
+    uint64_t oneKeywordBytes = rejected ? filesystem::file_size(oneKeywordPath) : 0;
+    rejected = rejected &&
+               rejectsCorruptTable(oneKeywordPath, {{40, ~7ull, 8}, {48, 0, 8}, {56, oneKeywordBytes, 8}, {76, oneKeywordBytes, 4}}) &&
+               rejectsCorruptTable(tablePath, {{16, fileBytes - 1, 8}}) &&
+               rejectsCorruptTable(tablePath, {{16, (fileBytes - 72) / 16 + 1, 8}}) &&
+               rejectsCorruptTable(tablePath, {{40, fileBytes + 8, 8}}) &&
+               rejectsCorruptTable(tablePath, {{72 + 4, 0xFFFFFFFFu, 4}}) &&
+               rejectsCorruptTable(tablePath, {{72 + 8, 0, 4}}) &&
+               rejectsCorruptTable(tablePath, {{72 + 4 * n, 0, 4}});
+    filesystem::remove(oneKeywordPath);
+    report("篡改的.kwtb文件头", rejected ? 1 : 0, "", rejected ? "全部拒绝" : "有未拒绝的文件！");
+
+    filesystem::remove(csvPath);
+    filesystem::remove(tablePath);
+}
+
+// ========== 关键词BST ==========
+
+void benchmarkBST(const vector<KeywordRow>& rows) {
+#ifdef USE_AVL_TREE
+    cout << "\n【关键词BST（AVL）】" << endl;
+#else
+    cout << "\n【关键词BST（普通BST）】" << endl;
+#endif
+    const size_t n = rows.size();
+    mt19937 rng(7);
+
+    // 插入顺序打乱，避免普通BST在有序输入上退化
+    vector<const KeywordRow*> shuffled;
+    for (const KeywordRow& row : rows) shuffled.push_back(&row);
+    shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    double insertMs = elapsedMs([&] {
+        for (const KeywordRow* row : shuffled) root = insert(root, row->keyword, row->freq, row->avg_novelty);
+    });
+    report("逐条插入", insertMs * 1e6 / n, "ns/次", "树高 " + to_string(treeHeight(root)));
+    printMemoryReport(rows);
+    report("整树释放", elapsedMs([] { clearTree(); }) * 1000, "us");
+    root = nullptr;
+
+    double bulkMs = elapsedMs([&] { root = bulkLoad(rows); });
+    report("批量建树", bulkMs, "ms", "树高 " + to_string(treeHeight(root)));
+
+    const int lookups = 1000000;
+    vector<string> queries;
+    for (int i = 0; i < lookups / 10; i++) {
+        string keyword = shuffled[i % n]->keyword;
+        if (i % 4 == 3) keyword += "#";  // 四分之一为未命中
+        queries.push_back(keyword);
+    }
+    int found = 0;
+    double searchMs = elapsedMs([&] {
+        for (int i = 0; i < lookups; i++) {
+            if (search(root, queries[i % queries.size()]) != nullptr) found++;
+        }
+    });
+    report("查找", searchMs * 1e6 / lookups, "ns/次", "命中 " + to_string(found) + " 次");
+
+    KeywordSnapshot snapshot(root);
+    SnapshotEntry entry;
+    found = 0;
+    double snapshotMs = elapsedMs([&] {
+        for (int i = 0; i < lookups; i++) {
+            if (snapshot.search(queries[i % queries.size()], entry) != nullptr) found++;
+        }
+    });
+    report("快照查找", snapshotMs * 1e6 / lookups, "ns/次", "命中 " + to_string(found) + " 次");
+
+    // 批量查找：每批256个关键词，分别按原顺序和批内排序后查找，与逐个search的结果比对
+    const size_t batchSize = 256;
+    vector<string_view> batchKeys(queries.begin(), queries.end());
+    vector<string_view> sortedBatchKeys = batchKeys;
+    for (size_t i = 0; i < sortedBatchKeys.size(); i += batchSize) {
+        sort(sortedBatchKeys.begin() + i, sortedBatchKeys.begin() + min(i + batchSize, sortedBatchKeys.size()));
+    }
+    vector<TreeNode*> batchResults(queries.size());
+    auto measureBatches = [&](const vector<string_view>& keys, const string& name) {
+        const int passes = lookups / (int)keys.size();
+        double ms = elapsedMs([&] {
+            for (int pass = 0; pass < passes; pass++) {
+                for (size_t i = 0; i < keys.size(); i += batchSize) {
+                    searchBatch(root, keys.data() + i, min(batchSize, keys.size() - i), batchResults.data() + i);
+                }
+            }
+        });
+        bool consistent = true;
+        for (size_t i = 0; i < keys.size() && consistent; i++) {
+            consistent = batchResults[i] == search(root, string(keys[i]));
+        }
+        report(name, passes * keys.size() / (ms / 1000) / 1e6, "M次/s", consistent ? "" : "结果与search不一致！");
+    };
+    report("逐个search", lookups / (searchMs / 1000) / 1e6, "M次/s");
+    measureBatches(batchKeys, "批量查找（无序批）");
+    measureBatches(sortedBatchKeys, "批量查找（有序批）");
+
+    // 删除十分之一的关键词后再插回去，树的内容恢复原样
+    size_t deleteCount = n / 10;
+    double deleteMs = elapsedMs([&] {
+        for (size_t i = 0; i < deleteCount; i++) root = deleteNode(root, shuffled[i]->keyword);
+    });
+    report("删除", deleteMs * 1e6 / max<size_t>(1, deleteCount), "ns/次", to_string(deleteCount) + " 个关键词");
+    for (size_t i = 0; i < deleteCount; i++) {
+        root = insert(root, shuffled[i]->keyword, shuffled[i]->freq, shuffled[i]->avg_novelty);
+    }
+
+    report("中序遍历（输出丢弃）", elapsedMsSilenced([] { inorderTraversal(root); }), "ms");
+    report("层次遍历（输出丢弃）", elapsedMsSilenced([] { levelorderTraversal(root); }), "ms");
+
+    // 随机区间：左边界取随机关键词，区间宽度约为0.1%的关键词
+    const int rangeQueries = 2000;
+    size_t width = max<size_t>(1, n / 1000);
+    size_t rangeHits = 0;
+    double rangeMs = elapsedMs([&] {
+        for (int i = 0; i < rangeQueries; i++) {
+            size_t lo = rng() % n;
+            size_t hi = min(n - 1, lo + width);
+            rangeHits += rangeScan(root, rows[lo].keyword, rows[hi].keyword, [](TreeNode*) {});
+        }
+    });
+    report("区间扫描", rangeMs * 1000 / rangeQueries, "us/次", "平均命中 " + to_string(rangeHits / rangeQueries) + " 个");
+
+    // 区间计数与汇总：逐个累加与沿边界路径读子树汇总值，宽度为0.1%和50%的关键词
+    for (size_t aggregateWidth : {width, n / 2}) {
+        vector<pair<size_t, size_t>> bounds;
+        for (int i = 0; i < rangeQueries; i++) {
+            size_t lo = rng() % n;
+            bounds.push_back({lo, min(n - 1, lo + aggregateWidth)});
+        }
+        int64_t scanFreq = 0, aggregateFreq = 0;
+        double scanSumMs = elapsedMs([&] {
+            for (const auto& bound : bounds) {
+                rangeScan(root, rows[bound.first].keyword, rows[bound.second].keyword, [&](TreeNode* node) { scanFreq += node->freq; });
+            }
+        });
+        double aggregateMs = elapsedMs([&] {
+            for (const auto& bound : bounds) {
+                aggregateFreq += rangeAggregate(root, rows[bound.first].keyword, rows[bound.second].keyword).freqSum;
+            }
+        });
+        string note = "区间宽度 " + to_string(aggregateWidth) + (scanFreq == aggregateFreq ? "" : "，结果不一致！");
+        report("区间汇总（逐个累加，宽" + to_string(aggregateWidth) + "）", scanSumMs * 1000 / rangeQueries, "us/次", note);
+        report("区间汇总（子树汇总值，宽" + to_string(aggregateWidth) + "）", aggregateMs * 1000 / rangeQueries, "us/次", note);
+    }
+    size_t rankChecks = 0;
+    double rankMs = elapsedMs([&] {
+        for (int i = 0; i < rangeQueries; i++) {
+            size_t k = rng() % n;
+            if (keywordRank(root, selectByRank(root, k)->keyword) == k) rankChecks++;
+        }
+    });
+    report("按名次选取+求排名", rankMs * 1000 / rangeQueries, "us/次", rankChecks == (size_t)rangeQueries ? "" : "结果不一致！");
+    report("区间查询（输出丢弃）", elapsedMsSilenced([&] { rangeQuery(root, rows[0].keyword, rows[n / 2].keyword); }), "ms");
+
+    // 随机阈值下全表扫描与二级索引
+    const int filterQueries = 200;
+    uniform_real_distribution<double> novelty(0.0, 20.0);
+    uniform_int_distribution<int> freq(4, 200);
+    vector<pair<double, int>> thresholds;
+    for (int i = 0; i < filterQueries; i++) thresholds.push_back({novelty(rng), freq(rng)});
+    size_t scanned = 0, indexed = 0;
+    double scanMs = elapsedMs([&] {
+        for (const auto& t : thresholds) scanned += scanByNoveltyAndFreq(root, t.first, t.second);
+    });
+    double indexMs = elapsedMs([&] {
+        for (const auto& t : thresholds) indexed += noveltyIndex.query(t.first, t.second, [](const NoveltyIndexEntry&) {});
+    });
+    string filterNote = "平均命中 " + to_string(scanned / filterQueries) + " 个" + (scanned == indexed ? "" : "，结果不一致！");
+    report("筛选（全表扫描）", scanMs * 1000 / filterQueries, "us/次", filterNote);
+    report("筛选（二级索引）", indexMs * 1000 / filterQueries, "us/次", filterNote);
+
+    // 取前K个：全表扫描+部分排序 与 二级索引（按子树最大频率最佳优先 / 按新颖度逆序遍历并剪枝）
+    auto byFreq = [](const NoveltyIndexEntry& a, const NoveltyIndexEntry& b) {
+        return a.freq != b.freq ? a.freq > b.freq : a.keyword < b.keyword;
+    };
+    auto byNovelty = [](const NoveltyIndexEntry& a, const NoveltyIndexEntry& b) {
+        return a.avg_novelty != b.avg_novelty ? a.avg_novelty > b.avg_novelty : a.keyword > b.keyword;
+    };
+    auto scanTop = [&](size_t k, int minFreq, bool novelty) {
+        vector<NoveltyIndexEntry> entries;
+        for (RangeCursor cursor(root, nullopt, nullopt); TreeNode* node = cursor.next();) {
+            if (node->freq >= minFreq) entries.push_back({node->keyword, node->id, node->freq, node->avg_novelty});
+        }
+        size_t kept = min(k, entries.size());
+        if (novelty) {
+            partial_sort(entries.begin(), entries.begin() + kept, entries.end(), byNovelty);
+        } else {
+            partial_sort(entries.begin(), entries.begin() + kept, entries.end(), byFreq);
+        }
+        entries.resize(kept);
+        return entries;
+    };
+    auto sameEntries = [](const vector<NoveltyIndexEntry>& a, const vector<NoveltyIndexEntry>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i].keyword != b[i].keyword) return false;
+        }
+        return true;
+    };
+    const int topQueries = 50;
+    for (size_t k : {10, 50, 1000}) {
+        vector<int> minFreqs;
+        for (int i = 0; i < topQueries; i++) minFreqs.push_back(freq(rng));
+        bool consistent = sameEntries(scanTop(k, 0, false), noveltyIndex.topByFreq(k));
+        for (int minFreq : minFreqs) {
+            consistent = consistent && sameEntries(scanTop(k, minFreq, true), noveltyIndex.topByNovelty(k, minFreq));
+        }
+        string note = consistent ? "" : "结果不一致！";
+        string suffix = "（K=" + to_string(k) + "）";
+        report("按频率取前K，扫描+部分排序" + suffix, elapsedMs([&] {
+            for (int i = 0; i < topQueries; i++) scanTop(k, 0, false);
+        }) * 1000 / topQueries, "us/次", note);
+        report("按频率取前K，二级索引" + suffix, elapsedMs([&] {
+            for (int i = 0; i < topQueries; i++) noveltyIndex.topByFreq(k);
+        }) * 1000 / topQueries, "us/次", note);
+        report("按新颖度取前K，扫描+部分排序" + suffix, elapsedMs([&] {
+            for (int minFreq : minFreqs) scanTop(k, minFreq, true);
+        }) * 1000 / topQueries, "us/次", note);
+        report("按新颖度取前K，二级索引" + suffix, elapsedMs([&] {
+            for (int minFreq : minFreqs) noveltyIndex.topByNovelty(k, minFreq);
+        }) * 1000 / topQueries, "us/次", note);
+    }
+
+    // 频率随新颖度单调增加的极端数据：按频率的顺序与按新颖度的顺序一致，检查树高不会退化
+    const int correlated = 1000000;
+    NoveltyFreqIndex correlatedIndex;
+    double correlatedBuildMs = elapsedMs([&] {
+        for (int i = 0; i < correlated; i++) {
+            correlatedIndex.insert("c" + to_string(i), NO_KEYWORD_ID, i + 1, i * 0.001);
+        }
+    });
+    size_t correlatedHits = 0;
+    double correlatedQueryMs = elapsedMs([&] {
+        correlatedHits = correlatedIndex.query(0.0, 1, [](const NoveltyIndexEntry&) {});
+    });
+    vector<NoveltyIndexEntry> correlatedByFreq, correlatedByNovelty;
+    double correlatedTopMs = elapsedMs([&] {
+        correlatedByFreq = correlatedIndex.topByFreq(1000);
+        correlatedByNovelty = correlatedIndex.topByNovelty(1000, correlated / 2);
+    });
+    bool correlatedOk = correlatedHits == (size_t)correlated && sameEntries(correlatedByFreq, correlatedByNovelty) &&
+                        !correlatedByFreq.empty() && correlatedByFreq[0].freq == correlated;
+    string correlatedNote = to_string(correlated) + " 个" + (correlatedOk ? "" : "，结果不一致！");
+    report("相关数据：建立二级索引", correlatedBuildMs, "ms", correlatedNote);
+    report("相关数据：全部命中的筛选", correlatedQueryMs, "ms", correlatedNote);
+    report("相关数据：两种取前K（K=1000）", correlatedTopMs * 1000, "us", correlatedNote);
+
+    clearTree();
+    root = nullptr;
+}
+
+// ========== 关键词ID ==========
+
+// 同一组关键词按同样的顺序插入两次，树形完全相同：一次字典为空（节点没有ID，逐个比较字符串），
+// 一次先建好保序字典（节点带ID，下降时只比较整数），对比查找、区间汇总、排名和索引筛选
+void benchmarkKeywordIds(const vector<KeywordRow>& rows) {
+    cout << "\n【关键词ID与字符串比较】" << endl;
+    const size_t n = rows.size();
+    mt19937 rng(13);
+    vector<const KeywordRow*> shuffled;
+    for (const KeywordRow& row : rows) shuffled.push_back(&row);
+    shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    const int lookups = 1000000;
+    vector<string> hits, misses;
+    for (int i = 0; i < lookups / 10; i++) {
+        hits.push_back(shuffled[i % n]->keyword);
+        misses.push_back(shuffled[i % n]->keyword + "#");
+    }
+    const int rangeQueries = 20000;
+    vector<pair<string, string>> bounds;
+    for (int i = 0; i < rangeQueries; i++) {
+        size_t lo = rng() % n;
+        size_t hi = min(n - 1, lo + rng() % max<size_t>(1, n / 10));
+        bounds.push_back({rows[lo].keyword, rows[hi].keyword});
+    }
+    const int filterPasses = 20;
+
+    struct Timings {
+        double hit, miss, range, rank, filter;
+        int64_t checksum;
+    };
+    auto measure = [&](bool withIds) {
+        clearTree();
+        root = nullptr;
+        if (withIds) {
+            for (const KeywordRow& row : rows) keywordDictionary.append(row.keyword);
+        }
+        for (const KeywordRow* row : shuffled) root = insert(root, row->keyword, row->freq, row->avg_novelty);
+
+        Timings t = {0, 0, 0, 0, 0, 0};
+        t.hit = elapsedMs([&] {
+            for (int i = 0; i < lookups; i++) t.checksum += search(root, hits[i % hits.size()])->freq;
+        });
+        t.miss = elapsedMs([&] {
+            for (int i = 0; i < lookups; i++) t.checksum += search(root, misses[i % misses.size()]) != nullptr;
+        });
+        t.range = elapsedMs([&] {
+            for (const auto& bound : bounds) t.checksum += rangeAggregate(root, bound.first, bound.second).freqSum;
+        });
+        t.rank = elapsedMs([&] {
+            for (const auto& bound : bounds) t.checksum += keywordRank(root, bound.first);
+        });
+        t.filter = elapsedMsSilenced([&] {
+            for (int pass = 0; pass < filterPasses; pass++) t.checksum += filterByNoveltyAndFreqIndexed(0, 1);
+        });
+        return t;
+    };
+
+    Timings byString = measure(false);
+    Timings byId = measure(true);
+
+    // 拿着ID查找（如哈夫曼解码出的关键词），不经过字典
+    int64_t idChecksum = 0;
+    double searchByIdMs = elapsedMs([&] {
+        for (int i = 0; i < lookups; i++) idChecksum += searchById(root, (uint32_t)(rng() % n))->freq;
+    });
+    string consistent = byString.checksum == byId.checksum ? "" : "，结果不一致！";
+    auto speedup = [](double before, double after) {
+        ostringstream note;
+        note.precision(3);
+        note << "字符串比较的 " << before / after << " 倍";
+        return note.str();
+    };
+
+    report("字典内存", (double)keywordDictionary.memoryBytes() / n, "bytes/关键词");
+    report("查找命中（字符串比较）", byString.hit * 1e6 / lookups, "ns/次");
+    report("查找命中（ID比较，含查字典）", byId.hit * 1e6 / lookups, "ns/次", speedup(byString.hit, byId.hit) + consistent);
+    report("按ID查找", searchByIdMs * 1e6 / lookups, "ns/次", speedup(byString.hit, searchByIdMs));
+    report("查找未命中（字符串比较）", byString.miss * 1e6 / lookups, "ns/次");
+    report("查找未命中（查字典后比较字符串）", byId.miss * 1e6 / lookups, "ns/次", speedup(byString.miss, byId.miss));
+    report("区间汇总（字符串比较）", byString.range * 1e6 / rangeQueries, "ns/次");
+    report("区间汇总（ID比较）", byId.range * 1e6 / rangeQueries, "ns/次", speedup(byString.range, byId.range));
+    report("排名（字符串比较）", byString.rank * 1e6 / rangeQueries, "ns/次");
+    report("排名（ID比较）", byId.rank * 1e6 / rangeQueries, "ns/次", speedup(byString.rank, byId.rank));
+    report("索引筛选全部关键词（按关键词排序）", byString.filter / filterPasses, "ms");
+    report("索引筛选全部关键词（按ID排序）", byId.filter / filterPasses, "ms", speedup(byString.filter, byId.filter));
+    clearTree();
+    root = nullptr;
+}
+
+// ========== 结果导出 ==========
+
+void benchmarkDump(const vector<KeywordRow>& rows) {
+    cout << "\n【中序导出（写入临时文件）】" << endl;
+    root = bulkLoad(rows);
+    string dumpPath = (filesystem::temp_directory_path() / "benchmark_dump.txt").string();
+    unsigned threadCount = max(1u, thread::hardware_concurrency());
+    const int passes = 5;
+
+    // 原来的写法：每行 << endl，每行都刷新一次
+    size_t legacyBytes = 0;
+    double legacyMs = elapsedMs([&] {
+        for (int pass = 0; pass < passes; pass++) {
+            ofstream out(dumpPath, ios::binary);
+            for (RangeCursor cursor(root, nullopt, nullopt); TreeNode* node = cursor.next();) {
+                out << "Keyword: " << node->keyword << ", Freq: " << node->freq << ", Avg_Novelty: " << node->avg_novelty << endl;
+            }
+            legacyBytes = (size_t)out.tellp();
+        }
+    });
+    report("逐行endl（TEXT）", legacyBytes * passes / 1048576.0 / (legacyMs / 1000), "MB/s");
+
+    const pair<RowFormat, string> formats[] = {{RowFormat::TEXT, "TEXT"}, {RowFormat::CSV, "CSV"}, {RowFormat::JSON_LINES, "JSON-lines"}};
+    for (const auto& format : formats) {
+        for (unsigned threads : {1u, threadCount}) {
+            size_t bytes = 0;
+            double ms = elapsedMs([&] {
+                for (int pass = 0; pass < passes; pass++) {
+                    ofstream out(dumpPath, ios::binary);
+                    bytes = dumpInOrder(root, out, format.first, threads);
+                }
+            });
+            string note = threads == 1 || threadCount > 1 ? "" : "只有1个CPU核";
+            report("缓冲导出（" + format.second + "，" + to_string(threads) + " 线程）", bytes * passes / 1048576.0 / (ms / 1000), "MB/s", note);
+            if (threadCount == 1) break;
+        }
+    }
+
+    // 导出结果应与（缓冲后的）中序遍历逐字节相同
+    ostringstream traversal, dump;
+    streambuf* saved = cout.rdbuf(traversal.rdbuf());
+    inorderTraversal(root);
+    cout.rdbuf(saved);
+    dumpInOrder(root, dump, RowFormat::TEXT, threadCount);
+    cout << "  并行导出与中序遍历" << (traversal.str() == dump.str() ? "一致" : "不一致！") << endl;
+
+    filesystem::remove(dumpPath);
+    clearTree();
+    root = nullptr;
+}
+
+// ========== 基数树与BST对比 ==========
+
+// BST上的前缀查询：从第一个 >= prefix 的节点起顺序读，遇到不以prefix开头的关键词为止
+template <class Visit>
+size_t bstPrefixScan(TreeNode* root, string_view prefix, Visit visit) {
+    RangeCursor cursor(root, prefix, nullopt);
+    size_t count = 0;
+    while (TreeNode* node = cursor.next()) {
+        if (node->keyword.compare(0, prefix.length(), prefix) != 0) break;
+        visit(node);
+        count++;
+    }
+    return count;
+}
+
+void benchmarkRadixTree(const vector<KeywordRow>& rows) {
+    cout << "\n【基数树（ART）与BST对比】" << endl;
+    size_t n = rows.size();
+    root = bulkLoad(rows);
+    RadixKeywordTree radix;
+    double loadMs = elapsedMs([&] { radix.load(rows); });
+    report("基数树建树", loadMs, "ms", to_string(radix.size()) + " 个关键词");
+
+    size_t bstBytes = nodePool.nodeBytesReserved() + nodePool.keywordArena().bytesReserved();
+    report("BST内存", (double)bstBytes / n, "bytes/关键词");
+    report("基数树内存", (double)radix.memoryBytes() / n, "bytes/关键词");
+
+    mt19937 rng(11);
+    const int lookups = 1000000;
+    vector<string> queries;
+    for (int i = 0; i < lookups / 10; i++) {
+        string keyword = rows[rng() % n].keyword;
+        if (i % 4 == 3) keyword += "#";  // 四分之一为未命中
+        queries.push_back(keyword);
+    }
+    bool consistent = true;
+    for (const string& query : queries) {
+        TreeNode* node = search(root, query);
+        const RadixLeaf* leaf = radix.search(query);
+        if ((node == nullptr) != (leaf == nullptr) || (node != nullptr && node->freq != leaf->freq)) consistent = false;
+    }
+    size_t found = 0;
+    double bstMs = elapsedMs([&] {
+        for (int i = 0; i < lookups; i++) {
+            if (search(root, queries[i % queries.size()]) != nullptr) found++;
+        }
+    });
+    report("BST查找", bstMs * 1e6 / lookups, "ns/次");
+    double radixMs = elapsedMs([&] {
+        for (int i = 0; i < lookups; i++) {
+            if (radix.search(queries[i % queries.size()]) != nullptr) found++;
+        }
+    });
+    report("基数树查找", radixMs * 1e6 / lookups, "ns/次", consistent ? "" : "结果与BST不一致！");
+
+    // 自动补全：随机关键词的前2、3、4个字节作为前缀，按字典序列出全部匹配 / 取频率最高的10个
+    const int prefixQueries = 20000;
+    const size_t topK = 10;
+    vector<string> prefixes;
+    for (int i = 0; i < prefixQueries; i++) {
+        const string& keyword = rows[rng() % n].keyword;
+        prefixes.push_back(keyword.substr(0, 2 + i % 3));
+    }
+    size_t bstHits = 0, radixHits = 0;
+    double bstPrefixMs = elapsedMs([&] {
+        for (const string& prefix : prefixes) bstHits += bstPrefixScan(root, prefix, [](TreeNode*) {});
+    });
+    double radixPrefixMs = elapsedMs([&] {
+        for (const string& prefix : prefixes) radixHits += radix.forEachWithPrefix(prefix, [](const RadixLeaf&) {});
+    });
+    string prefixNote = "平均命中 " + to_string(radixHits / prefixQueries) + " 个" + (bstHits == radixHits ? "" : "，结果不一致！");
+    report("BST前缀列举", bstPrefixMs * 1000 / prefixQueries, "us/次", prefixNote);
+    report("基数树前缀列举", radixPrefixMs * 1000 / prefixQueries, "us/次", prefixNote);
+
+    // BST没有频率信息可剪枝，只能列出全部匹配后部分排序
+    auto byFreq = [](TreeNode* a, TreeNode* b) { return a->freq != b->freq ? a->freq > b->freq : a->keyword < b->keyword; };
+    vector<TreeNode*> matches;
+    size_t topMismatches = 0;
+    double bstTopMs = elapsedMs([&] {
+        for (const string& prefix : prefixes) {
+            matches.clear();
+            bstPrefixScan(root, prefix, [&](TreeNode* node) { matches.push_back(node); });
+            size_t k = min(topK, matches.size());
+            partial_sort(matches.begin(), matches.begin() + k, matches.end(), byFreq);
+        }
+    });
+    double radixTopMs = elapsedMs([&] {
+        for (const string& prefix : prefixes) radix.topByFreq(prefix, topK);
+    });
+    for (int i = 0; i < prefixQueries; i += 100) {
+        matches.clear();
+        bstPrefixScan(root, prefixes[i], [&](TreeNode* node) { matches.push_back(node); });
+        size_t k = min(topK, matches.size());
+        partial_sort(matches.begin(), matches.begin() + k, matches.end(), byFreq);
+        vector<const RadixLeaf*> top = radix.topByFreq(prefixes[i], topK);
+        bool same = top.size() == k;
+        for (size_t j = 0; j < k && same; j++) same = top[j]->keyword == matches[j]->keyword;
+        if (!same) topMismatches++;
+    }
+    string topNote = topMismatches == 0 ? "" : "结果不一致！";
+    report("BST前缀取前10（扫描+部分排序）", bstTopMs * 1000 / prefixQueries, "us/次", topNote);
+    report("基数树前缀取前10", radixTopMs * 1000 / prefixQueries, "us/次", topNote);
+
+    clearTree();
+    root = nullptr;
+}
+
+// ========== 多版本树：读线程与写线程并发 ==========
+
+void benchmarkVersionedTree(const vector<KeywordRow>& rows) {
+    cout << "\n【多版本树（写线程持续更新时的读吞吐）】" << endl;
+    VersionedKeywordTree tree;
+    report("建树", elapsedMs([&] { tree.load(rows); }), "ms");
+
+    unsigned hardwareThreads = max(1u, thread::hardware_concurrency());
+    vector<unsigned> readerCounts = {1};
+    for (unsigned t = 2; t <= max(2u, hardwareThreads); t *= 2) readerCounts.push_back(t);
+
+    const auto duration = chrono::milliseconds(300);
+    for (unsigned readerCount : readerCounts) {
+        atomic<bool> stop(false);
+        atomic<uint64_t> totalReads(0);
+        vector<thread> readers;
+        for (unsigned r = 0; r < readerCount; r++) {
+            readers.emplace_back([&, r] {
+                VersionedKeywordTree::Reader reader(tree);
+                mt19937 rng(100 + r);
+                SnapshotEntry entry;
+                uint64_t reads = 0;
+                while (!stop.load(memory_order_relaxed)) {
+                    for (int i = 0; i < 256; i++) {
+                        reader.search(rows[rng() % rows.size()].keyword, entry);
+                    }
+                    reads += 256;
+                }
+                totalReads += reads;
+            });
+        }
+
+        // 写线程：随机删除一个关键词再插回去（频率加1），每次更新发布两个版本
+        uint64_t versionsBefore = tree.version();
+        mt19937 rng(200);
+        auto start = chrono::steady_clock::now();
+        while (chrono::steady_clock::now() - start < duration) {
+            const KeywordRow& row = rows[rng() % rows.size()];
+            tree.erase(row.keyword);
+            tree.insert(row.keyword, row.freq + 1, row.avg_novelty);
+        }
+        stop = true;
+        for (thread& reader : readers) reader.join();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        report(to_string(readerCount) + " 个读线程", totalReads / seconds / 1e6, "M次/s",
+               "写线程发布 " + to_string((uint64_t)((tree.version() - versionsBefore) / seconds)) + " 个版本/s，待回收节点 " +
+               to_string(tree.pendingReclaim()));
+    }
+}
+
+// ========== 哈夫曼编码 ==========
+
+void benchmarkHuffman(const vector<KeywordRow>& rows) {
+    cout << "\n【哈夫曼编码】" << endl;
+    vector<string> keywords;
+    vector<int> freqs;
+    for (const KeywordRow& row : rows) {
+        keywords.push_back(row.keyword);
+        freqs.push_back(row.freq);
+    }
+
+    HuffmanTree heapTree, tree;
+    report("优先队列建树", elapsedMs([&] { heapTree = buildHuffmanTree(keywords, freqs); }), "ms");
+    report("双队列线性建树", elapsedMs([&] { tree = buildHuffmanTreeLinear(keywords, freqs); }), "ms");
+
+    vector<int> optimalLengths, limitedLengths;
+    report("求最优码长", elapsedMs([&] { optimalLengths = computeCodeLengths(tree, keywords.size()); }), "ms");
+    report("限制码长（package-merge）",
+           elapsedMs([&] { limitedLengths = limitCodeLengths(freqs, DEFAULT_MAX_CODE_LENGTH); }), "ms");
+
+    vector<BitCode> codes;
+    report("生成范式编码", elapsedMs([&] { codes = generateCodes(limitedLengths); }), "ms");
+    report("压缩率分析（输出丢弃）", elapsedMsSilenced([&] { analyzeCompression(keywords, freqs, codes, optimalLengths); }), "ms");
+
+    vector<uint32_t> symbols = sampleOccurrences(freqs);
+    vector<uint8_t> payload;
+    uint64_t bitCount = 0;
+    double encodeMs = elapsedMs([&] { bitCount = encodeSymbols(symbols, codes, payload); });
+    report("编码", symbols.size() / (encodeMs / 1000) / 1e6, "M符号/s", to_string(bitCount / 8 / 1024) + " KB");
+
+    vector<uint32_t> decoded;
+    bool treeOk = false;
+    double treeDecodeMs = elapsedMs([&] { treeOk = decodeSymbols(payload, symbols.size(), codes, decoded); });
+    report("逐位解码", symbols.size() / (treeDecodeMs / 1000) / 1e6, "M符号/s", treeOk && decoded == symbols ? "" : "解码结果不一致！");
+
+    TableDecoder decoder;
+    decoder.build(codes);
+    bool tableOk = false;
+    double tableDecodeMs = elapsedMs([&] { tableOk = decoder.decode(payload, symbols.size(), decoded); });
+    report("查表解码", symbols.size() / (tableDecodeMs / 1000) / 1e6, "M符号/s", tableOk && decoded == symbols ? "" : "解码结果不一致！");
+}
+
+int main(int argc, char* argv[]) {
+    size_t rowCount = argc > 1 ? strtoull(argv[1], nullptr, 10) : 200000;
+    string resultPath = argc > 2 ? argv[2] : "";
+    if (rowCount == 0) {
+        cerr << "用法: benchmark [专利行数] [结果CSV路径]" << endl;
+        return 1;
+    }
+    size_t vocabularySize = max<size_t>(1000, rowCount / 10);
+
+    cout << "========== 性能测试 ==========" << endl;
+    string csv;
+    double generateMs = elapsedMs([&] { csv = generatePatentCSV(rowCount, vocabularySize); });
+    cout << "合成数据: " << rowCount << " 行，词表 " << vocabularySize << " 个关键词，"
+         << csv.size() / 1048576.0 << " MB（生成耗时 " << generateMs << " ms）" << endl;
+
+    vector<KeywordRow> rows = benchmarkAnalysis(csv);
+    csv.clear();
+    csv.shrink_to_fit();
+    if (rows.empty()) {
+        cerr << "错误: 没有统计到任何关键词" << endl;
+        return 1;
+    }
+    benchmarkTableLoading(rows);
+    benchmarkBST(rows);
+    benchmarkKeywordIds(rows);
+    benchmarkDump(rows);
+    benchmarkRadixTree(rows);
+    benchmarkVersionedTree(rows);
+    benchmarkHuffman(rows);
+
+    if (!resultPath.empty()) {
+        ofstream out(resultPath);
+        if (!out.is_open()) {
+            cerr << "无法创建结果文件: " << resultPath << endl;
+            return 1;
+        }
+        out << "name,value,unit" << endl;
+        for (const BenchResult& result : results) {
+            out << result.name << "," << result.value << "," << result.unit << endl;
+        }
+        cout << "\n结果已写入: " << resultPath << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,282 @@
+#include "csv_scanner.h"
+#include "keyword_analysis.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSV_SCANNER_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CSV_TARGET_AVX2
+#else
+#define CSV_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+using namespace std;
+
+ScanPath bestScanPath() {
+    if (scanPathSupported(ScanPath::AVX2)) return ScanPath::AVX2;
+    if (scanPathSupported(ScanPath::SSE2)) return ScanPath::SSE2;
+    return ScanPath::SCALAR;
+}
+
+bool scanPathSupported(ScanPath path) {
+    switch (path) {
+    case ScanPath::SCALAR:
+        return true;
+#ifdef CSV_SCANNER_X86
+    case ScanPath::SSE2:
+        return true;  // x86-64的基本指令集
+    case ScanPath::AVX2: {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+const char* scanPathName(ScanPath path) {
+    switch (path) {
+    case ScanPath::SSE2:
+        return "SSE2";
+    case ScanPath::AVX2:
+        return "AVX2";
+    default:
+        return "scalar";
+    }
+}
+
+// 一块64字节中各类字符的位置，第i位对应第i个字节
+struct BlockMasks {
+    uint64_t quote;
+    uint64_t comma;
+    uint64_t open;
+    uint64_t close;
+    uint64_t newline;
+};
+
+static inline int trailingZeros(uint64_t bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// 前缀异或：第i位变为原来第0..i位的异或，即该字节之后是否处在引号内
+static inline uint64_t prefixXor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+// 把一块的位掩码变成结构字符位置追加到out，inQuote/inBracket带入上一块结束时的状态并更新为本块结束时的状态
+static inline uint32_t* emitBlock(const BlockMasks& m, uint64_t& inQuote, uint64_t& inBracket, uint32_t base, uint32_t* out) {
+    uint64_t quoted = prefixXor(m.quote) ^ inQuote;
+    // 每行开头引号状态重置：换行处仍在引号内时，把它之后的状态整体翻转（引号在行内成对时不会发生）
+    for (uint64_t open = m.newline & quoted; open != 0; open = m.newline & quoted) {
+        quoted ^= ~0ULL << trailingZeros(open);
+    }
+
+    // 中括号不计嵌套，只看最近的一个是'['还是']'（换行视为']'）：把每个已知位置的状态向后涂抹到下一个已知位置为止
+    uint64_t bracketed = inBracket;
+    uint64_t known = m.open | m.close | m.newline;
+    if (known != 0) {
+        bracketed = m.open;
+        for (int shift = 1; shift < 64; shift *= 2) {
+            bracketed |= (bracketed << shift) & ~known;
+            known |= known << shift;
+        }
+        bracketed |= ~known & inBracket;
+    }
+
+    inQuote = (uint64_t)((int64_t)quoted >> 63);
+    inBracket = (uint64_t)((int64_t)bracketed >> 63);
+
+    uint64_t structural = (m.comma & ~quoted & ~bracketed) | m.quote | m.newline;
+    while (structural != 0) {
+        *out++ = base + trailingZeros(structural);
+        structural &= structural - 1;
+    }
+    return out;
+}
+
+static uint32_t* scanBlocksScalar(const char* p, size_t blocks, uint64_t& inQuote, uint64_t& inBracket, uint32_t base, uint32_t* out) {
+    for (size_t b = 0; b < blocks; b++, p += 64, base += 64) {
+        BlockMasks m = {0, 0, 0, 0, 0};
+        for (int i = 0; i < 64; i++) {
+            uint64_t bit = 1ULL << i;
+            switch (p[i]) {
+            case '"':
+                m.quote |= bit;
+                break;
+            case ',':
+                m.comma |= bit;
+                break;
+            case '[':
+                m.open |= bit;
+                break;
+            case ']':
+                m.close |= bit;
+                break;
+            case '\n':
+                m.newline |= bit;
+                break;
+            }
+        }
+        out = emitBlock(m, inQuote, inBracket, base, out);
+    }
+    return out;
+}
+
+#ifdef CSV_SCANNER_X86
+static inline uint64_t equalMaskSSE2(const __m128i chunks[4], char c) {
+    __m128i pattern = _mm_set1_epi8(c);
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; i++) {
+        mask |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[i], pattern)) << (16 * i);
+    }
+    return mask;
+}
+
+static uint32_t* scanBlocksSSE2(const char* p, size_t blocks, uint64_t& inQuote, uint64_t& inBracket, uint32_t base, uint32_t* out) {
+    for (size_t b = 0; b < blocks; b++, p += 64, base += 64) {
+        __m128i chunks[4];
+        for (int i = 0; i < 4; i++) {
+            chunks[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        }
+        BlockMasks m;
+        m.quote = equalMaskSSE2(chunks, '"');
+        m.comma = equalMaskSSE2(chunks, ',');
+        m.open = equalMaskSSE2(chunks, '[');
+        m.close = equalMaskSSE2(chunks, ']');
+        m.newline = equalMaskSSE2(chunks, '\n');
+        out = emitBlock(m, inQuote, inBracket, base, out);
+    }
+    return out;
+}
+
+CSV_TARGET_AVX2 static inline uint64_t equalMaskAVX2(__m256i low, __m256i high, char c) {
+    __m256i pattern = _mm256_set1_epi8(c);
+    uint64_t lowMask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, pattern));
+    uint64_t highMask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, pattern));
+    return lowMask | (highMask << 32);
+}
+
+CSV_TARGET_AVX2 static uint32_t* scanBlocksAVX2(const char* p, size_t blocks, uint64_t& inQuote, uint64_t& inBracket, uint32_t base, uint32_t* out) {
+    for (size_t b = 0; b < blocks; b++, p += 64, base += 64) {
+        __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        BlockMasks m;
+        m.quote = equalMaskAVX2(low, high, '"');
+        m.comma = equalMaskAVX2(low, high, ',');
+        m.open = equalMaskAVX2(low, high, '[');
+        m.close = equalMaskAVX2(low, high, ']');
+        m.newline = equalMaskAVX2(low, high, '\n');
+        out = emitBlock(m, inQuote, inBracket, base, out);
+    }
+    return out;
+}
+#endif
+
+CSVScanner::CSVScanner(string_view data, ScanPath path) : data(data), path(scanPathSupported(path) ? path : ScanPath::SCALAR) {
+    index.resize(min(data.length(), BATCH_BYTES));
+}
+
+void CSVScanner::scanBatch() {
+    typedef uint32_t* (*ScanBlocks)(const char*, size_t, uint64_t&, uint64_t&, uint32_t, uint32_t*);
+    ScanBlocks scanBlocks = scanBlocksScalar;
+#ifdef CSV_SCANNER_X86
+    if (path == ScanPath::AVX2) scanBlocks = scanBlocksAVX2;
+    if (path == ScanPath::SSE2) scanBlocks = scanBlocksSSE2;
+#endif
+
+    batchBase = scanned;
+    size_t length = min(data.length() - scanned, BATCH_BYTES);
+    size_t fullBlocks = length / 64;
+    const char* p = data.data() + scanned;
+    uint32_t* out = scanBlocks(p, fullBlocks, inQuote, inBracket, 0, index.data());
+
+    // 不足64字节的尾部复制到空格填充的缓冲区里再扫描，不读出data的范围
+    size_t tail = length - fullBlocks * 64;
+    if (tail > 0) {
+        char padded[64];
+        memset(padded, ' ', sizeof(padded));
+        memcpy(padded, p + fullBlocks * 64, tail);
+        out = scanBlocks(padded, 1, inQuote, inBracket, (uint32_t)(fullBlocks * 64), out);
+    }
+
+    indexSize = out - index.data();
+    next = 0;
+    scanned += length;
+}
+
+bool CSVScanner::nextRecord(vector<string_view>& fields, vector<string_view>& keywords, double& novelty) {
+    fields.clear();
+    quotes.clear();
+    size_t lineStart = pos;
+    size_t fieldStart = pos;
+    size_t lineEnd;
+    for (;;) {
+        size_t p = nextStructural();
+        if (p >= data.length()) {
+            lineEnd = data.length();
+            break;
+        }
+        char c = data[p];
+        if (c == '\n') {
+            lineEnd = p;
+            break;
+        }
+        if (c == ',') {
+            fields.push_back(data.substr(fieldStart, p - fieldStart));
+            fieldStart = p + 1;
+        } else if (fields.size() == 7) {
+            quotes.push_back(p);
+        }
+    }
+    pos = lineEnd + 1;
+
+    // 与nextLine一样去掉Windows换行的\r，与parseCSVLine一样空行没有字段、以逗号结尾时最后有一个空字段
+    if (lineEnd > lineStart && data[lineEnd - 1] == '\r') {
+        lineEnd--;
+    }
+    if (lineEnd > lineStart) {
+        fields.push_back(data.substr(fieldStart, lineEnd - fieldStart));
+    }
+
+    if (fields.size() < 9 || !parseDouble(fields[8], novelty)) {
+        return false;
+    }
+
+    // Keywords字段从引号外开始，每对引号之间是一个关键词（末尾未闭合的引号忽略），与parseKeywords相同
+    keywords.clear();
+    for (size_t i = 0; i + 1 < quotes.size(); i += 2) {
+        size_t start = quotes[i] + 1;
+        size_t end = quotes[i + 1];
+        if (end > start) {
+            string_view trimmed = trim(data.substr(start, end - start));
+            if (!trimmed.empty()) {
+                keywords.push_back(trimmed);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef CSV_SCANNER_H
+#define CSV_SCANNER_H
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 向量化的专利CSV结构扫描，分两遍：
+// 第一遍每次取64字节，用SIMD比较一次得到 引号、中括号、逗号、换行 的位掩码；引号掩码做前缀异或得到引号内的区域，
+// 中括号按位移“涂抹”得到括号内的区域，两者之外的逗号才是字段分隔符，把 分隔逗号/引号/换行 的位置写进索引。
+// 第二遍按索引切出字段和Keywords字段中成对引号之间的关键词，不再逐字节判断。
+// 引号、中括号状态与parseCSVLine一样在每行开头重置，结果与 nextLine + parseRecord 逐行解析完全相同
+
+// 第一遍使用的指令集：AVX2（每块两次32字节比较）、SSE2（四次16字节比较）、逐字节（没有SIMD的平台）
+enum class ScanPath { SCALAR, SSE2, AVX2 };
+
+// 本机可用的最快路径（运行时检测CPU）
+ScanPath bestScanPath();
+bool scanPathSupported(ScanPath path);
+const char* scanPathName(ScanPath path);
+
+// 逐行读取data中的专利记录
+class CSVScanner {
+public:
+    explicit CSVScanner(std::string_view data, ScanPath path = bestScanPath());
+
+    // 是否已读完（与 while (pos < data.length()) nextLine(data, pos) 的循环条件相同）
+    bool done() const { return pos >= data.length(); }
+
+    // 读取下一行，结果与 parseRecord(nextLine(data, pos), fields, keywords, novelty) 相同：该行是有效记录时返回true
+    bool nextRecord(std::vector<std::string_view>& fields, std::vector<std::string_view>& keywords, double& novelty);
+
+private:
+    // 每批扫描的字节数，索引按批复用，位置用相对批开头的32位偏移
+    static constexpr size_t BATCH_BYTES = 64 * 1024;
+
+    // 下一个结构字符的位置，没有时返回data.length()
+    size_t nextStructural() {
+        while (next == indexSize) {
+            if (scanned >= data.length()) return data.length();
+            scanBatch();
+        }
+        return batchBase + index[next++];
+    }
+    void scanBatch();
+
+    std::string_view data;
+    ScanPath path;
+    size_t pos = 0;        // 下一行的开头
+    size_t scanned = 0;    // 第一遍已扫描到的位置
+    size_t batchBase = 0;  // 当前批的开头
+    std::vector<uint32_t> index;
+    size_t indexSize = 0;
+    size_t next = 0;
+    uint64_t inQuote = 0;    // 上一块结束时是否在引号内（全1或0）
+    uint64_t inBracket = 0;  // 上一块结束时是否在中括号内
+    std::vector<size_t> quotes;  // 当前行Keywords字段中的引号位置
+};
+
+#endif
@@ -1,328 +1,182 @@
-#include <iostream>
-#include <fstream>
-#include <sstream>
-#include <string>
-#include <vector>
-#include <queue>
-using namespace std;
-
-string CSV_FILE_PATH = "E:\\InnovationDataset\\DeepInnovationAI\\DeepPatentAI_1979-1981_keyword_analysis_result.csv";
-
-// 树节点结构
-
-struct TreeNode {
-    string keyword;
-    int freq;
-    double avg_novelty;
-    TreeNode *left, *right;
-
-    TreeNode(string k, int f, double a) : keyword(k), freq(f), avg_novelty(a), left(nullptr), right(nullptr) {}
-};
-
-TreeNode* root = nullptr;
-// 插入操作
-
-TreeNode* insert(TreeNode* node, string keyword, int freq, double avg_novelty) {
-    if (node == nullptr) {   //出口，空就插入
-        return new TreeNode(keyword, freq, avg_novelty);
-    }
-
-    if (keyword < node->keyword) {
-        node->left = insert(node->left, keyword, freq, avg_novelty);
-    } else if (keyword > node->keyword) {
-        node->right = insert(node->right, keyword, freq, avg_novelty);
-    } else {
-        // 相等则更新
-        node->freq = freq;
-        node->avg_novelty = avg_novelty;
-    }
-
-    return node;
-}
-
-// 查找操作
-
-TreeNode* search(TreeNode* node, string keyword) {
-    if (node == nullptr || node->keyword == keyword) {
-        return node;
-    }
-
-    if (keyword < node->keyword) {
-        return search(node->left, keyword);
-    } else {
-        return search(node->right, keyword);
-    }
-}
-
-// 删除操作
-
-TreeNode* findMin(TreeNode* node) {
-    while (node->left != nullptr) {
-        node = node->left;
-    }
-    return node;
-}
-
-TreeNode* deleteNode(TreeNode* node, string keyword) {
-    if (node == nullptr) {
-        return nullptr;
-    }
-
-    if (keyword < node->keyword) {
-        node->left = deleteNode(node->left, keyword);
-    } else if (keyword > node->keyword) {
-        node->right = deleteNode(node->right, keyword);
-    } else {
-        // 找到要删除的节点
-
-        // 情况1：叶子节点
-        if (node->left == nullptr && node->right == nullptr) {
-            delete node;
-            return nullptr;
-        }
-        // 情况2：只有右子树
-        else if (node->left == nullptr) {
-            TreeNode* temp = node->right;//用右子树代填删除的结点
-            delete node;
-            return temp;
-        }
-        // 情况3：只有左子树
-        else if (node->right == nullptr) {
-            TreeNode* temp = node->left;
-            delete node;
-            return temp;
-        }
-        // 情况4：有两个子树（用中序后继替代）
-        else {
-            TreeNode* temp = findMin(node->right);
-            node->keyword = temp->keyword;
-            node->freq = temp->freq;
-            node->avg_novelty = temp->avg_novelty;
-            node->right = deleteNode(node->right, temp->keyword);
-        }
-    }
-
-    return node;
-}
-
-// 先序遍历（Pre-order）
-void preorderTraversal(TreeNode* node) {
-    if (node != nullptr) {
-        cout << "Keyword: " << node->keyword
-             << ", Freq: " << node->freq
-             << ", Avg_Novelty: " << node->avg_novelty << endl;
-        preorderTraversal(node->left);
-        preorderTraversal(node->right);
-    }
-}
-
-// 中序遍历（In-order）
-void inorderTraversal(TreeNode* node) {
-    if (node != nullptr) {
-        inorderTraversal(node->left);
-        cout << "Keyword: " << node->keyword
-             << ", Freq: " << node->freq
-             << ", Avg_Novelty: " << node->avg_novelty << endl;
-        inorderTraversal(node->right);
-    }
-}
-
-// 后序遍历（Post-order）
-void postorderTraversal(TreeNode* node) {
-    if (node != nullptr) {
-        postorderTraversal(node->left);
-        postorderTraversal(node->right);
-        cout << "Keyword: " << node->keyword
-             << ", Freq: " << node->freq
-             << ", Avg_Novelty: " << node->avg_novelty << endl;
-    }
-}
-
-// 层次遍历（Level-order）
-void levelorderTraversal(TreeNode* root) {
-    if (root == nullptr) return;
-
-    queue<TreeNode*> q;
-    q.push(root);
-
-    while (!q.empty()) {
-        TreeNode* current = q.front();
-        q.pop();
-
-        cout << "Keyword: " << current->keyword
-             << ", Freq: " << current->freq
-             << ", Avg_Novelty: " << current->avg_novelty << endl;
-
-        if (current->left != nullptr) {
-            q.push(current->left);
-        }
-        if (current->right != nullptr) {
-            q.push(current->right);
-        }
-    }
-}
-
-
-
-// 区间查询：中序遍历输出所有满足 L <= keyword <= R 的节点
-
-void rangeQueryHelper(TreeNode* node, string L, string R) {
-    if (node == nullptr) return;
-
-    // 中序遍历：左子树
-    rangeQueryHelper(node->left, L, R);
-
-    // 处理当前节点：如果在区间内，输出
-    if (node->keyword >= L && node->keyword <= R) {
-        cout << "Keyword: " << node->keyword
-             << ", Freq: " << node->freq
-             << ", Avg_Novelty: " << node->avg_novelty << endl;
-    }
-
-    // 中序遍历：右子树
-    rangeQueryHelper(node->right, L, R);
-}
-
-// 区间查询主函数
-bool rangeQuery(TreeNode* root, string L, string R) {
-    // 先检查左边界是否存在
-    TreeNode* leftNode = search(root, L);
-    if (leftNode == nullptr) {
-        cout << "错误：左边界 \"" << L << "\" 不存在于BST中！" << endl;
-        return false;
-    }
-
-    // 再检查右边界是否存在
-    TreeNode* rightNode = search(root, R);
-    if (rightNode == nullptr) {
-        cout << "错误：右边界 \"" << R << "\" 不存在于BST中！" << endl;
-        return false;
-    }
-
-    // 检查左边界是否小于等于右边界
-    if (L > R) {
-        cout << "错误：左边界 \"" << L << "\" 大于右边界 \"" << R << "\"！" << endl;
-        return false;
-    }
-
-    // 执行中序遍历区间查询
-    rangeQueryHelper(root, L, R);
-    return true;
-}
-
-// 按新颖性和频率筛选关键词
-void filterByNoveltyAndFreq(TreeNode* node, double minNovelty, int minFreq) {
-    if (node == nullptr) return;
-
-    filterByNoveltyAndFreq(node->left, minNovelty, minFreq);
-
-    if (node->avg_novelty >= minNovelty && node->freq >= minFreq) {
-        cout << "Keyword: " << node->keyword
-             << ", Freq: " << node->freq
-             << ", Avg_Novelty: " << node->avg_novelty << endl;
-    }
-
-    filterByNoveltyAndFreq(node->right, minNovelty, minFreq);
-}
-
-
-int main() {
-    ifstream file(CSV_FILE_PATH);
-    if (!file.is_open()) {
-        cout << "无法打开文件！" << endl;
-        return 1;
-    }
-
-    string line;
-    bool isHeader = true;
-
-    while (getline(file, line)) {
-        if (isHeader) {
-            isHeader = false;
-            continue;
-        }
-
-        stringstream ss(line);
-        string keyword, freqStr, noveltyStr;
-
-        getline(ss, keyword, ',');
-        getline(ss, freqStr, ',');
-        getline(ss, noveltyStr, ',');
-
-        if (!keyword.empty()) {
-            root = insert(root, keyword, stoi(freqStr), stod(noveltyStr));
-        }
-    }
-    file.close();
-    cout << "BST构建完成！\n" << endl;
-
-
-
-    cout << "========== 查找操作 ==========" << endl;
-    string searchKey = "voice";  // 这里可以填入你要查找的关键词
-    TreeNode* result = search(root, searchKey);
-    if (result != nullptr) {
-        cout << "找到: " << result->keyword
-             << ", 频率: " << result->freq
-             << ", 新颖度: " << result->avg_novelty << endl;
-    } else {
-        cout << "未找到: " << searchKey << endl;
-    }
-    cout << endl;
-
-
-    cout << "========== 插入操作 ==========" << endl;
-    root = insert(root, "new_keyword", 6, 11.764);
-    cout << "插入 new_keyword 成功！" << endl;
-    cout << endl;
-
-
-    cout << "========== 删除操作 ==========" << endl;
-    string deleteKey = "voice";  // 修改为你要删除的关键词
-    TreeNode* deleteResult = search(root, deleteKey);
-    if (deleteResult != nullptr) {
-        root = deleteNode(root, deleteKey);
-        cout << "删除 " << deleteKey << " 完成！" << endl;
-    } else {
-        cout << "未找到 " << deleteKey << "，无法删除！" << endl;
-    }
-    cout << endl;
-
-
-    cout << "========== 先序遍历（Pre-order）==========" << endl;
-    preorderTraversal(root);
-    cout << endl;
-
-    cout << "========== 中序遍历（In-order）- 字典序输出 ==========" << endl;
-    inorderTraversal(root);
-    cout << endl;
-
-    cout << "========== 后序遍历（Post-order）==========" << endl;
-    postorderTraversal(root);
-    cout << endl;
-
-    cout << "========== 层次遍历（Level-order）==========" << endl;
-    levelorderTraversal(root);
-    cout << endl;
-
-
-    cout << "========== 区间查询 ==========" << endl;
-    string L = "method";  // 在这里填入区间左边界
-    string R = "recognizing";    // 在这里填入区间右边界
-    cout << "查询区间 [" << L << ", " << R << "] 内的关键词（中序遍历）：" << endl;
-    if (!rangeQuery(root, L, R)) {
-        cout << "区间查询失败！" << endl;
-    }
-    cout << endl;
-
-
-    cout << "========== 按新颖性和频率筛选 ==========" << endl;
-    double minNovelty = 8.2;  // 在这里填入最低新颖度
-    int minFreq = 4;         // 在这里填入最低频率
-    cout << "筛选条件：avg_novelty >= " << minNovelty
-         << " 且 freq >= " << minFreq << endl;
-    filterByNoveltyAndFreq(root, minNovelty, minFreq);
-    cout << endl;
-
-    return 0;
-}
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "keyword_bst.h"
+#include "stats.h"
+using namespace std;
+
+// 编译时加 -DUSE_AVL_TREE 切换为AVL自平衡模式（接口不变），默认为普通BST；性能测试见 benchmark.cpp
+
+string CSV_FILE_PATH = "E:\\InnovationDataset\\DeepInnovationAI\\DeepPatentAI_1979-1981_keyword_analysis_result.csv";
+
+int main(int argc, char* argv[]) {
+    // 也可以在命令行指定：experiment_3_BST [关键词CSV或.kwtb] [变化CSV] [--stats JSON路径] [--format text|csv|jsonl] [--dump 导出路径]
+    // 变化CSV是分析程序增量模式输出的 *_delta.csv，建树后直接在树上应用，不必用新的结果重新建树。
+    // 指定 --stats 时结束前把各操作的计数、各阶段耗时和节点深度分布写成JSON（路径为 - 时输出到屏幕）。
+    // --format 选择遍历、查询结果的行格式（默认text）；--dump 把整棵树按中序多线程导出到文件
+    string statsPath, dumpPath;
+    vector<string> positional;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--stats" && i + 1 < argc) {
+            statsPath = argv[++i];
+        } else if (string(argv[i]) == "--format" && i + 1 < argc) {
+            if (!parseRowFormat(argv[++i], outputFormat)) {
+                cout << "未知的输出格式: " << argv[i] << "（可选 text、csv、jsonl）" << endl;
+                return 1;
+            }
+        } else if (string(argv[i]) == "--dump" && i + 1 < argc) {
+            dumpPath = argv[++i];
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+    if (positional.size() > 0) CSV_FILE_PATH = positional[0];
+
+    if (isKeywordTablePath(CSV_FILE_PATH)) {
+        // 二进制统计表：映射后直接由各列建树，不解析文本
+        KeywordTableFile table;
+        if (!table.open(CSV_FILE_PATH)) {
+            cout << "无法打开文件！" << endl;
+            return 1;
+        }
+        root = bulkLoad(table);
+    } else {
+        vector<KeywordRow> rows;
+        if (!readKeywordCSV(CSV_FILE_PATH, rows)) {
+            cout << "无法打开文件！" << endl;
+            return 1;
+        }
+        root = bulkLoad(rows);  // CSV已按关键词排序，O(n)建出平衡树
+    }
+    cout << "BST构建完成！\n" << endl;
+
+    if (positional.size() > 1) {
+        vector<KeywordDelta> deltas;
+        if (!readKeywordDelta(positional[1], deltas)) {
+            cout << "无法打开变化文件！" << endl;
+            return 1;
+        }
+        root = applyKeywordDelta(root, deltas);
+        cout << "应用了 " << deltas.size() << " 条变化。\n" << endl;
+    }
+
+    if (!dumpPath.empty()) {
+        ofstream dumpFile(dumpPath, ios::binary);
+        if (!dumpFile.is_open()) {
+            cout << "无法创建导出文件！" << endl;
+            return 1;
+        }
+        auto dumpStart = chrono::steady_clock::now();
+        size_t dumpBytes = dumpInOrder(root, dumpFile, outputFormat);
+        dumpFile.close();
+        double dumpSeconds = chrono::duration<double>(chrono::steady_clock::now() - dumpStart).count();
+        cout << "已导出到 " << dumpPath << "：" << dumpBytes / 1048576.0 << " MB，"
+             << dumpBytes / 1048576.0 / max(dumpSeconds, 1e-9) << " MB/s\n" << endl;
+    }
+
+
+
+    cout << "========== 查找操作 ==========" << endl;
+    string searchKey = "voice";  // 这里可以填入你要查找的关键词
+    TreeNode* result = search(root, searchKey);
+    if (result != nullptr) {
+        cout << "找到: " << result->keyword
+             << ", 频率: " << result->freq
+             << ", 新颖度: " << result->avg_novelty << endl;
+    } else {
+        cout << "未找到: " << searchKey << endl;
+    }
+    cout << endl;
+
+
+    cout << "========== 插入操作 ==========" << endl;
+    root = insert(root, "new_keyword", 6, 11.764);
+    cout << "插入 new_keyword 成功！" << endl;
+    cout << endl;
+
+
+    cout << "========== 删除操作 ==========" << endl;
+    string deleteKey = "voice";  // 修改为你要删除的关键词
+    TreeNode* deleteResult = search(root, deleteKey);
+    if (deleteResult != nullptr) {
+        root = deleteNode(root, deleteKey);
+        cout << "删除 " << deleteKey << " 完成！" << endl;
+    } else {
+        cout << "未找到 " << deleteKey << "，无法删除！" << endl;
+    }
+    cout << endl;
+
+
+    cout << "========== 先序遍历（Pre-order）==========" << endl;
+    preorderTraversal(root);
+    cout << endl;
+
+    cout << "========== 中序遍历（In-order）- 字典序输出 ==========" << endl;
+    inorderTraversal(root);
+    cout << endl;
+
+    cout << "========== 后序遍历（Post-order）==========" << endl;
+    postorderTraversal(root);
+    cout << endl;
+
+    cout << "========== 层次遍历（Level-order）==========" << endl;
+    levelorderTraversal(root);
+    cout << endl;
+
+
+    cout << "========== 区间查询 ==========" << endl;
+    string L = "method";  // 在这里填入区间左边界
+    string R = "recognizing";    // 在这里填入区间右边界
+    cout << "查询区间 [" << L << ", " << R << "] 内的关键词（中序遍历）：" << endl;
+    if (!rangeQuery(root, L, R)) {
+        cout << "区间查询失败！" << endl;
+    }
+    cout << endl;
+
+    cout << "========== 区间汇总 ==========" << endl;
+    if (L <= R) {
+        RangeAggregate summary = rangeAggregate(root, L, R);
+        cout << "区间 [" << L << ", " << R << "] 内共 " << summary.count << " 个关键词"
+             << "，总频率 " << summary.freqSum
+             << "，按频率加权的平均新颖度 " << summary.weightedNovelty() << endl;
+        cout << "\"" << L << "\" 的排名: " << keywordRank(root, L) << " / " << (root != nullptr ? root->size : 0) << endl;
+        if (TreeNode* median = selectByRank(root, (root != nullptr ? root->size : 0) / 2)) {
+            cout << "字典序居中的关键词: " << median->keyword << endl;
+        }
+    }
+    cout << endl;
+
+
+    cout << "========== 按新颖性和频率筛选 ==========" << endl;
+    double minNovelty = 8.2;  // 在这里填入最低新颖度
+    int minFreq = 4;         // 在这里填入最低频率
+    cout << "筛选条件：avg_novelty >= " << minNovelty
+         << " 且 freq >= " << minFreq << endl;
+    filterByNoveltyAndFreqIndexed(minNovelty, minFreq);
+    cout << endl;
+
+    cout << "========== 频率最高的关键词 ==========" << endl;
+    size_t topK = 10;  // 在这里填入要列出的个数
+    printTopByFreq(topK);
+    cout << endl;
+
+    cout << "========== 新颖度最高的关键词 ==========" << endl;
+    cout << "条件：freq >= " << minFreq << endl;
+    printTopByNovelty(topK, minFreq);
+    cout << endl;
+
+    if (!statsPath.empty()) {
+        statsCounter("bst.nodes") = nodePool.nodeCount();
+        statsCounter("bst.height") = treeHeight(root);
+        statsHistogram("bst.depth", depthHistogram(root));
+        if (!writeStatsJSON(statsPath)) {
+            cerr << "无法写入统计文件: " << statsPath << endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -1,209 +1,154 @@
-#include <iostream>
-#include <fstream>
-#include <sstream>
-#include <string>
-#include <vector>
-#include <map>
-
-using namespace std;
-
-// 去除字符串首尾空格
-string trim(const string& str) {
-    size_t start = 0;
-    size_t end = str.length();
-
-    // 找到第一个非空格字符
-    while (start < end && isspace(str[start])) {
-        start++;
-    }
-
-    // 找到最后一个非空格字符
-    while (end > start && isspace(str[end - 1])) {
-        end--;
-    }
-
-    return str.substr(start, end - start);
-}
-
-// 检查关键词是否有效（不包含特殊字符）
-bool isValidKeyword(const string& keyword) {
-    if (keyword.empty()) {
-        return false;
-    }
-
-    // 检查是否包含中括号、引号、逗号等特殊字符
-    for (char c : keyword) {
-        if (c == '[' || c == ']' || c == '"' || c == '\'' || c == '\\' || c == ',') {
-            return false;
-        }
-    }
-
-    // 检查是否只是空格
-    bool hasNonSpace = false;
-    for (char c : keyword) {
-        if (!isspace(c)) {
-            hasNonSpace = true;
-            break;
-        }
-    }
-
-    return hasNonSpace;
-}
-
-// 解析Keywords字段，提取所有关键词
-vector<string> parseKeywords(const string& keywordField) {
-    vector<string> keywords;
-    string current = "";
-    bool inQuote = false;
-
-    for (size_t i = 0; i < keywordField.length(); i++) {
-        char c = keywordField[i];
-
-        if (c == '"') {
-            inQuote = !inQuote;
-            // 当引号关闭时，保存当前关键词（去除空格）
-            if (!inQuote && !current.empty()) {
-                string trimmed = trim(current);
-                if (!trimmed.empty()) {
-                    keywords.push_back(trimmed);
-                }
-                current = "";
-            }
-        } else if (inQuote) {
-            current += c;
-        }
-    }
-
-    return keywords;
-}
-
-// 解析CSV行，处理可能包含逗号的字段
-vector<string> parseCSVLine(const string& line) {
-    vector<string> fields;
-    string current = "";
-    bool inQuote = false;
-    bool inBracket = false;
-
-    for (size_t i = 0; i < line.length(); i++) {
-        char c = line[i];
-
-        if (c == '"') {
-            inQuote = !inQuote;
-            current += c;
-        } else if (c == '[') {
-            inBracket = true;
-            current += c;
-        } else if (c == ']') {
-            inBracket = false;
-            current += c;
-        } else if (c == ',' && !inQuote && !inBracket) {
-            fields.push_back(current);
-            current = "";
-        } else {
-            current += c;
-        }
-    }
-
-    // 添加最后一个字段
-    if (!current.empty() || line.back() == ',') {
-        fields.push_back(current);
-    }
-
-    return fields;
-}
-
-int main() {
-    // ========== 在这里填写输入文件路径 ==========
-    string inputPath = "E:\\InnovationDataset\\DeepInnovationAI\\DeepPatentAI_1979-1981.csv";
-    // ===========================================
-
-    // 自动生成输出文件路径（与输入文件同目录）
-    string outputPath = "E:\\InnovationDataset\\DeepInnovationAI\\DeepPatentAI_1979-1981_keyword_analysis_result.csv";
-
-    ifstream inputFile(inputPath);
-    if (!inputFile.is_open()) {
-        cerr << "无法打开输入文件: " << inputPath << endl;
-        return 1;
-    }
-
-    // 存储每个关键词的频次和Novelty总和
-    map<string, int> keywordFreq;
-    map<string, double> keywordNoveltySum;
-
-    string line;
-    bool isHeader = true;
-    int lineCount = 0;
-
-    while (getline(inputFile, line)) {
-        if (isHeader) {
-            isHeader = false;
-            continue;
-        }
-
-        lineCount++;
-        vector<string> fields = parseCSVLine(line);
-
-        // 检查是否有足够的列（至少需要9列）
-        if (fields.size() < 9) {
-            continue;
-        }
-
-        // 第八列是Keywords（索引7），第九列是Novelty（索引8）
-        string keywordsField = fields[7];
-        string noveltyStr = fields[8];
-
-        // 解析Novelty值
-        double novelty = 0.0;
-        try {
-            novelty = stod(noveltyStr);
-        } catch (...) {
-            // 如果无法解析Novelty，跳过这一行
-            continue;
-        }
-
-        // 解析Keywords
-        vector<string> keywords = parseKeywords(keywordsField);
-
-        // 统计每个关键词（只统计有效的关键词）
-        for (const string& keyword : keywords) {
-            if (isValidKeyword(keyword)) {
-                keywordFreq[keyword]++;
-                keywordNoveltySum[keyword] += novelty;
-            }
-        }
-    }
-
-    inputFile.close();
-
-    // 输出结果
-    ofstream outputFile(outputPath);
-    if (!outputFile.is_open()) {
-        cerr << "无法创建输出文件: " << outputPath << endl;
-        return 1;
-    }
-
-    // 写入表头
-    outputFile << "keyword,freq,avg_novelty" << endl;
-
-    int outputCount = 0;
-    for (const auto& entry : keywordFreq) {
-        string keyword = entry.first;
-        int freq = entry.second;
-
-        // 只保留freq >= 4的关键词
-        if (freq >= 4) {
-            double avgNovelty = keywordNoveltySum[keyword] / freq;
-            outputFile << keyword << "," << freq << "," << avgNovelty << endl;
-            outputCount++;
-        }
-    }
-
-    outputFile.close();
-
-    cout << "处理了 " << lineCount << " 行数据。" << endl;
-    cout << "共找到 " << keywordFreq.size() << " 个不同的关键词。" << endl;
-    cout << "输出了 " << outputCount << " 个频次>=4的关键词。" << endl;
-    cout << "输出文件: " << outputPath << endl;
-
-    return 0;
-}
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <vector>
+#include "keyword_analysis.h"
+#include "keyword_table_file.h"
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    // ========== 在这里填写输入文件路径 ==========
+    string inputPath = "E:\\InnovationDataset\\DeepInnovationAI\\DeepPatentAI_1979-1981.csv";
+    // ===========================================
+
+    // 自动生成输出文件路径（与输入文件同目录）
+    string outputPath = "E:\\InnovationDataset\\DeepInnovationAI\\DeepPatentAI_1979-1981_keyword_analysis_result.csv";
+
+    // 也可以在命令行指定：experiment_3_analysis [输入CSV] [输出CSV] [线程数] [--checkpoint 检查点路径] [--binary 二进制统计表路径]
+    // 线程数默认取CPU核数，多线程与单线程的输出文件逐字节相同。
+    // 指定检查点时为增量模式：只统计上次运行之后追加的行，另外输出与上次结果相比的变化（<输出CSV>_delta.csv）。
+    // 指定二进制统计表路径时，同样的结果再写一份.kwtb，BST和哈夫曼程序可以直接映射使用
+    unsigned threadCount = max(1u, thread::hardware_concurrency());
+    string checkpointPath;
+    string binaryPath;
+    vector<string> positional;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--checkpoint" && i + 1 < argc) {
+            checkpointPath = argv[++i];
+        } else if (string(argv[i]) == "--binary" && i + 1 < argc) {
+            binaryPath = argv[++i];
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+    if (positional.size() > 0) inputPath = positional[0];
+    if (positional.size() > 1) outputPath = positional[1];
+    if (positional.size() > 2) threadCount = max(1, atoi(positional[2].c_str()));
+
+    auto startTime = chrono::steady_clock::now();
+
+    MappedFile inputFile;
+    if (!inputFile.open(inputPath)) {
+        cerr << "无法打开输入文件: " << inputPath << endl;
+        return 1;
+    }
+    string_view data = inputFile.view();
+
+    // 统计状态：每个关键词的频次和Novelty总和，增量模式下最后写回检查点
+    AnalysisCheckpoint state;
+    KeywordTable& keywordTable = state.table;
+
+    // 增量模式：检查点可用时从上次处理到的位置继续，否则跳过表头从头统计
+    KeywordTable previousTable;
+    size_t bodyStart = 0;
+    bool resumed = false;
+    if (!checkpointPath.empty() && loadCheckpoint(checkpointPath, state)) {
+        previousTable = keywordTable;
+        if (canResumeFrom(state, data)) {
+            bodyStart = state.inputOffset;
+            resumed = true;
+        } else {
+            cout << "输入文件不是在上次处理的基础上追加的，重新完整统计。" << endl;
+            state = AnalysisCheckpoint();
+        }
+    }
+    if (!resumed) {
+        nextLine(data, bodyStart);
+    }
+    string_view body = data.substr(min(bodyStart, data.length()));
+
+    if (threadCount > 1) {
+        state.lineCount += aggregateParallel(body, threadCount, keywordTable);
+    } else {
+        state.lineCount += aggregateSequential(body, keywordTable);
+    }
+    int lineCount = state.lineCount;
+
+    size_t inputBytes = body.length();
+    state.inputOffset = data.length();
+    state.boundaryHash = boundaryHash(data, data.length());
+    inputFile.close();
+    double elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+    // 输出结果
+    ofstream outputFile(outputPath);
+    if (!outputFile.is_open()) {
+        cerr << "无法创建输出文件: " << outputPath << endl;
+        return 1;
+    }
+
+    // 写入表头
+    outputFile << "keyword,freq,avg_novelty" << endl;
+
+    int outputCount = 0;
+    vector<string_view> outputKeywords;
+    vector<int> outputFreqs;
+    vector<double> outputNovelties;
+    for (uint32_t id : keywordTable.sortedIds()) {
+        const KeywordStats& stats = keywordTable.stats(id);
+
+        // 只保留freq >= 4的关键词
+        if (stats.freq >= 4) {
+            double avgNovelty = stats.noveltySum / stats.freq;
+            outputFile << keywordTable.keywordAt(id) << "," << stats.freq << "," << avgNovelty << endl;
+            outputCount++;
+            if (!binaryPath.empty()) {
+                outputKeywords.push_back(keywordTable.keywordAt(id));
+                outputFreqs.push_back(stats.freq);
+                outputNovelties.push_back(avgNovelty);
+            }
+        }
+    }
+
+    outputFile.close();
+
+    if (!binaryPath.empty()) {
+        if (!writeKeywordTableFile(binaryPath, outputKeywords, outputFreqs, outputNovelties)) {
+            cerr << "无法写入二进制统计表: " << binaryPath << endl;
+            return 1;
+        }
+        cout << "二进制统计表: " << binaryPath << endl;
+    }
+
+    if (!checkpointPath.empty()) {
+        string deltaPath = outputPath.substr(0, outputPath.rfind('.')) + "_delta.csv";
+        ofstream deltaFile(deltaPath);
+        if (!deltaFile.is_open()) {
+            cerr << "无法创建变化文件: " << deltaPath << endl;
+            return 1;
+        }
+        int changeCount = writeKeywordDelta(deltaFile, previousTable, keywordTable, 4);
+        deltaFile.close();
+
+        if (!saveCheckpoint(checkpointPath, state)) {
+            cerr << "无法写入检查点: " << checkpointPath << endl;
+            return 1;
+        }
+
+        cout << (resumed ? "增量统计：" : "完整统计：") << "本次处理 " << inputBytes << " 字节，"
+             << changeCount << " 个关键词有变化（" << deltaPath << "）。" << endl;
+    }
+
+    cout << "处理了 " << lineCount << " 行数据（" << threadCount << " 个线程）。" << endl;
+    cout << "共找到 " << keywordTable.size() << " 个不同的关键词。" << endl;
+    cout << "输出了 " << outputCount << " 个频次>=4的关键词。" << endl;
+    cout << "输出文件: " << outputPath << endl;
+    cout << "读取与统计耗时: " << elapsedSeconds << " s（"
+         << inputBytes / 1048576.0 / elapsedSeconds << " MB/s）" << endl;
+
+    return 0;
+}
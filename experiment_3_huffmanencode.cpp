@@ -1,243 +1,200 @@
-#include <iostream>
-#include <fstream>
-#include <sstream>
-#include <string>
-#include <vector>
-#include <queue>
-#include <map>
-#include <cmath>
-#include <algorithm>
-
-using namespace std;
-
-// 哈夫曼树节点结构
-struct HuffmanNode {
-    string keyword;      // 关键词（只有叶子节点有）
-    int freq;           // 频率（权值）
-    HuffmanNode* left;  // 左子节点
-    HuffmanNode* right; // 右子节点
-
-    HuffmanNode(string kw, int f) : keyword(kw), freq(f), left(nullptr), right(nullptr) {}
-    HuffmanNode(int f) : keyword(""), freq(f), left(nullptr), right(nullptr) {}
-};
-
-// 优先队列的比较器（小顶堆）
-struct CompareNode {
-    bool operator()(HuffmanNode* a, HuffmanNode* b) {
-        return a->freq > b->freq; // 频率小的优先级高
-    }
-};
-
-// 读取CSV文件
-bool readCSV(const string& filename, vector<string>& keywords, vector<int>& freqs, vector<double>& novelties) {
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "错误: 无法打开文件 " << filename << endl;
-        return false;
-    }
-
-    string line;
-    // 跳过表头
-    getline(file, line);
-
-    // 读取数据
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string keyword, freqStr, noveltyStr;
-
-        // 读取三列数据
-        getline(ss, keyword, ',');
-        getline(ss, freqStr, ',');
-        getline(ss, noveltyStr, ',');
-
-        if (!keyword.empty() && !freqStr.empty()) {
-            keywords.push_back(keyword);
-            freqs.push_back(stoi(freqStr));
-            if (!noveltyStr.empty()) {
-                novelties.push_back(stod(noveltyStr));
-            }
-        }
-    }
-
-    file.close();
-    return true;
-}
-
-// 构建哈夫曼树
-HuffmanNode* buildHuffmanTree(const vector<string>& keywords, const vector<int>& freqs) {
-    // 创建优先队列（小顶堆）
-    priority_queue<HuffmanNode*, vector<HuffmanNode*>, CompareNode> pq;
-
-    // 为每个关键词创建叶子节点并加入优先队列
-    for (size_t i = 0; i < keywords.size(); i++) {
-        HuffmanNode* node = new HuffmanNode(keywords[i], freqs[i]);
-        pq.push(node);
-    }
-
-    // 构建哈夫曼树
-    while (pq.size() > 1) {
-        // 取出两个最小权值的节点
-        HuffmanNode* left = pq.top();
-        pq.pop();
-        HuffmanNode* right = pq.top();
-        pq.pop();
-
-        // 合并为新节点
-        HuffmanNode* parent = new HuffmanNode(left->freq + right->freq);
-        parent->left = left;
-        parent->right = right;
-
-        // 将新节点插回优先队列
-        pq.push(parent);
-    }
-
-    // 返回根节点
-    return pq.empty() ? nullptr : pq.top();
-}
-
-// 递归生成哈夫曼编码
-void generateCodesHelper(HuffmanNode* root, const string& code, map<string, string>& codes) {
-    if (root == nullptr) return;
-
-    // 如果是叶子节点，保存编码
-    if (root->left == nullptr && root->right == nullptr) {
-        codes[root->keyword] = code.empty() ? "0" : code; // 特殊情况：只有一个节点时编码为"0"
-        return;
-    }
-
-    // 左分支记为0
-    if (root->left) {
-        generateCodesHelper(root->left, code + "0", codes);
-    }
-
-    // 右分支记为1
-    if (root->right) {
-        generateCodesHelper(root->right, code + "1", codes);
-    }
-}
-
-// 生成哈夫曼编码
-map<string, string> generateCodes(HuffmanNode* root) {
-    map<string, string> codes;//map是用来储存编码的
-    if (root == nullptr) return codes;
-
-    // 特殊情况：只有一个节点
-    if (root->left == nullptr && root->right == nullptr) {
-        codes[root->keyword] = "0";
-        return codes;
-    }
-
-    generateCodesHelper(root, "", codes);
-    return codes;
-}
-
-// 计算编码效果并分析压缩率
-void analyzeCompression(const vector<string>& keywords, const vector<int>& freqs,
-                        const map<string, string>& huffmanCodes) {
-    int N = keywords.size(); // 关键词数量
-
-    // 1. 定长编码
-    int fixedBitsPerKeyword = ceil(log2(N));
-    if (fixedBitsPerKeyword == 0) fixedBitsPerKeyword = 1; // 至少1位
-
-    long long totalFreq = 0; // 总频率（所有关键词出现次数之和）
-    for (int f : freqs) {
-        totalFreq += f;
-    }
-
-    long long fixedTotalBits = totalFreq * fixedBitsPerKeyword;
-
-    // 2. 哈夫曼编码
-    long long huffmanTotalBits = 0;
-    for (size_t i = 0; i < keywords.size(); i++) {
-        const string& keyword = keywords[i];
-        int freq = freqs[i];
-        int codeLength = huffmanCodes.at(keyword).length();
-        huffmanTotalBits += (long long)freq * codeLength;
-    }
-
-    // 3. 计算压缩率
-    double compressionRatio = (double)huffmanTotalBits / fixedTotalBits;
-
-    // 输出结果
-    cout << "\n========== 两种编码对比 ==========" << endl;
-    cout << "关键词总数 (N): " << N << endl;
-    cout << "关键词总出现次数: " << totalFreq << endl;
-    cout << "\n【定长编码】" << endl;
-    cout << "  总比特数: " << fixedTotalBits << " bits" << endl;
-    cout << "  每个关键词位数: " << fixedBitsPerKeyword << " bits" << endl;
-    cout << "\n【哈夫曼编码】" << endl;
-    cout << "  总比特数: " << huffmanTotalBits << " bits" << endl;
-    double avgCodeLength = (double)huffmanTotalBits / totalFreq;// 计算平均编码长度
-    cout << "  平均编码长度: " << avgCodeLength << " bits" << endl;
-    cout << "  压缩率 (Compression Ratio): " << compressionRatio << endl;
-}
-
-// 显示哈夫曼编码
-void displayHuffmanCodes(const map<string, string>& codes, int maxDisplay = 20) {
-    cout << "\n========== 哈夫曼编码 ==========" << endl;
-    cout << "显示 " << min((int)codes.size(), maxDisplay) << " 个关键词的编码:" << endl;
-
-    int count = 0;
-    for (const auto& pair : codes) {
-        if (count >= maxDisplay) break;
-        cout << "  " << pair.first << " -> " << pair.second << endl;
-        count++;
-    }
-
-    if (codes.size() > maxDisplay) {
-        cout << "  ... (还有 " << (codes.size() - maxDisplay) << " 个关键词)" << endl;
-    }
-}
-
-// 释放哈夫曼树内存
-void deleteHuffmanTree(HuffmanNode* root) {
-    if (root == nullptr) return;
-    deleteHuffmanTree(root->left);
-    deleteHuffmanTree(root->right);
-    delete root;
-}
-
-int main() {
-    // ========== 在此处填写CSV文件路径 ==========
-    string csvFilePath = "E:\\InnovationDataset\\DeepInnovationAI\\DeepPatentAI_1979-1981_keyword_analysis_result.csv";  // 请修改为你的CSV文件路径
-    // ==========================================
-
-    // 读取CSV文件
-    vector<string> keywords;
-    vector<int> freqs;
-    vector<double> novelties;
-
-    if (!readCSV(csvFilePath, keywords, freqs, novelties)) {
-        cerr << "程序终止。" << endl;
-        return 1;
-    }
-
-    cout << "读取 " << keywords.size() << " 个关键词" << endl;
-
-    if (keywords.empty()) {
-        cerr << "错误: 没有读取到任何数据" << endl;
-        return 1;
-    }
-
-    // 构建哈夫曼树
-    HuffmanNode* root = buildHuffmanTree(keywords, freqs);
-
-    if (root == nullptr) {
-        cerr << "错误: 哈夫曼树构建失败" << endl;
-        return 1;
-    }
-    // 生成哈夫曼编码
-    map<string, string> huffmanCodes = generateCodes(root);
-
-    // 显示哈夫曼编码
-    displayHuffmanCodes(huffmanCodes, 100);//100，最多显示100个，但实际上只有13个
-
-    // 分析压缩效果
-    analyzeCompression(keywords, freqs, huffmanCodes);
-
-    // 释放内存
-    deleteHuffmanTree(root);
-
-    return 0;
-}
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include "huffman.h"
+#include "keyword_table_file.h"
+#include "stats.h"
+using namespace std;
+
+// 实际压缩：编码关键词出现序列、写入并读回压缩文件、解码校验，输出真实文件大小和吞吐
+void runRealCompression(const vector<string>& keywords, const vector<int>& freqs,
+                        const vector<BitCode>& table, const string& outputPath) {
+    cout << "\n========== 实际压缩 ==========" << endl;
+
+    vector<uint32_t> symbols = sampleOccurrences(freqs);
+    size_t rawBytes = 0;  // 每个关键词占一行的文本大小
+    for (uint32_t symbol : symbols) rawBytes += keywords[symbol].length() + 1;
+
+    vector<uint8_t> payload;
+    auto t0 = chrono::steady_clock::now();
+    uint64_t bitCount = encodeSymbols(symbols, table, payload);
+    auto t1 = chrono::steady_clock::now();
+    double encodeSeconds = chrono::duration<double>(t1 - t0).count();
+
+    if (!writeCompressedFile(outputPath, keywords, table, symbols.size(), bitCount, payload)) {
+        cerr << "错误: 无法写入压缩文件 " << outputPath << endl;
+        return;
+    }
+
+    vector<string> fileKeywords;
+    vector<BitCode> fileTable;
+    uint64_t fileSymbolCount, fileBitCount;
+    vector<uint8_t> filePayload;
+    if (!readCompressedFile(outputPath, fileKeywords, fileTable, fileSymbolCount, fileBitCount, filePayload)) {
+        cerr << "错误: 无法读取压缩文件 " << outputPath << endl;
+        return;
+    }
+
+    vector<uint32_t> decoded;
+    t0 = chrono::steady_clock::now();
+    bool ok = decodeSymbols(filePayload, fileSymbolCount, fileTable, decoded);
+    t1 = chrono::steady_clock::now();
+    double decodeSeconds = chrono::duration<double>(t1 - t0).count();
+    ok = ok && fileKeywords == keywords && decoded == symbols;
+
+    TableDecoder tableDecoder;
+    bool tableOk = tableDecoder.build(fileTable);
+    t0 = chrono::steady_clock::now();
+    tableOk = tableOk && tableDecoder.decode(filePayload, fileSymbolCount, decoded);
+    t1 = chrono::steady_clock::now();
+    double tableDecodeSeconds = chrono::duration<double>(t1 - t0).count();
+    tableOk = tableOk && decoded == symbols;
+
+    ifstream written(outputPath, ios::binary | ios::ate);
+    size_t fileBytes = (size_t)written.tellg();
+
+    cout << "压缩文件: " << outputPath << endl;
+    cout << "关键词出现次数: " << symbols.size() << endl;
+    cout << "原始文本（每行一个关键词）: " << rawBytes << " bytes" << endl;
+    cout << "负载: " << bitCount << " bits（" << payload.size() << " bytes）" << endl;
+    cout << "文件总大小（含码表）: " << fileBytes << " bytes，相对原始文本 "
+         << (double)fileBytes / rawBytes << endl;
+    cout << "编码吞吐: " << symbols.size() / encodeSeconds / 1e6 << " M关键词/秒（"
+         << rawBytes / 1048576.0 / encodeSeconds << " MB/s）" << endl;
+    cout << "逐位解码吞吐: " << symbols.size() / decodeSeconds / 1e6 << " M关键词/秒（输出 "
+         << rawBytes / 1048576.0 / decodeSeconds << " MB/s，输入 "
+         << payload.size() / 1048576.0 / decodeSeconds << " MB/s）" << endl;
+    if (tableOk) {
+        cout << "查表解码吞吐: " << symbols.size() / tableDecodeSeconds / 1e6 << " M关键词/秒（输出 "
+             << rawBytes / 1048576.0 / tableDecodeSeconds << " MB/s，输入 "
+             << payload.size() / 1048576.0 / tableDecodeSeconds << " MB/s）" << endl;
+    } else {
+        cout << "查表解码: 失败（最大码长需不超过 " << TableDecoder::MAX_CODE_LENGTH << " 位）" << endl;
+    }
+    cout << "解码校验: " << (ok && tableOk ? "通过" : "失败") << endl;
+}
+
+// 按glibc malloc的块大小估算一次分配实际占用的字节数（8字节块头，16字节对齐，最小32字节）
+size_t mallocChunkBytes(size_t size) {
+    return max<size_t>(32, (size + 8 + 15) / 16 * 16);
+}
+
+// 每个关键词的内存占用：逐个new、节点内含std::string的旧布局 vs 节点池+字符串区
+void printMemoryReport(const vector<string>& keywords, const HuffmanTree& tree) {
+    struct LegacyHuffmanNode {
+        string keyword;
+        int freq;
+        LegacyHuffmanNode *left, *right;
+    };
+
+    // 旧布局中每个节点都有一个std::string，叶子的关键词超出短字符串优化(SSO)容量时另占一块堆内存
+    size_t legacyBytes = tree.nodes.size() * mallocChunkBytes(sizeof(LegacyHuffmanNode));
+    for (const string& kw : keywords) {
+        if (kw.length() >= sizeof(string) - 16) {
+            legacyBytes += mallocChunkBytes(kw.length() + 1);
+        }
+    }
+    size_t pooledBytes = tree.nodes.capacity() * sizeof(HuffmanNode) + tree.keywordArena.capacity();
+
+    cout << "\n========== 内存占用（每个关键词） ==========" << endl;
+    cout << "旧布局（new + std::string，估算）: " << (double)legacyBytes / keywords.size() << " bytes"
+         << "（节点 " << sizeof(LegacyHuffmanNode) << " bytes）" << endl;
+    cout << "节点池 + 字符串区: " << (double)pooledBytes / keywords.size() << " bytes"
+         << "（节点 " << sizeof(HuffmanNode) << " bytes）" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    // ========== 在此处填写CSV文件路径 ==========
+    string csvFilePath = "E:\\InnovationDataset\\DeepInnovationAI\\DeepPatentAI_1979-1981_keyword_analysis_result.csv";  // 请修改为你的CSV文件路径
+    // ==========================================
+
+    // 也可以在命令行指定：experiment_3_huffmanencode [关键词CSV或.kwtb] [压缩文件输出路径] [最大码长] [--stats JSON路径]
+    // 指定 --stats 时结束前把各阶段耗时、编解码计数和码长分布写成JSON（路径为 - 时输出到屏幕）
+    string statsPath;
+    vector<string> positional;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--stats" && i + 1 < argc) {
+            statsPath = argv[++i];
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+    if (positional.size() > 0) csvFilePath = positional[0];
+    string compressedPath = csvFilePath.substr(0, csvFilePath.rfind('.')) + "_huffman.bin";
+    if (positional.size() > 1) compressedPath = positional[1];
+    int maxCodeLength = DEFAULT_MAX_CODE_LENGTH;
+    if (positional.size() > 2) maxCodeLength = min(DEFAULT_MAX_CODE_LENGTH, atoi(positional[2].c_str()));  // 压缩文件的码长上限
+
+    // 读取CSV文件
+    vector<string> keywords;
+    vector<int> freqs;
+    vector<double> novelties;
+
+    bool loaded = isKeywordTablePath(csvFilePath) ? readKeywordTable(csvFilePath, keywords, freqs, novelties)
+                                                  : readCSV(csvFilePath, keywords, freqs, novelties);
+    if (!loaded) {
+        cerr << "程序终止。" << endl;
+        return 1;
+    }
+
+    cout << "读取 " << keywords.size() << " 个关键词" << endl;
+
+    if (keywords.empty()) {
+        cerr << "错误: 没有读取到任何数据" << endl;
+        return 1;
+    }
+
+    // 构建哈夫曼树（双队列线性构建，与优先队列版本的总码长相同）
+    HuffmanTree tree = buildHuffmanTreeLinear(keywords, freqs);
+
+    if (tree.root == NO_NODE) {
+        cerr << "错误: 哈夫曼树构建失败" << endl;
+        return 1;
+    }
+    // 生成哈夫曼编码：先取最优码长，超出码长限制时用package-merge重新分配，再生成范式编码
+    vector<int> optimalLengths = computeCodeLengths(tree, keywords.size());
+    vector<int> codeLengths = optimalLengths;
+    int minLength = max(1, (int)ceil(log2(keywords.size())));
+    if (maxCodeLength < minLength) {
+        cout << "码长限制 " << maxCodeLength << " 位不足以容纳 " << keywords.size()
+             << " 个关键词，改为 " << minLength << " 位" << endl;
+        maxCodeLength = minLength;
+    }
+    if (*max_element(optimalLengths.begin(), optimalLengths.end()) > maxCodeLength) {
+        codeLengths = limitCodeLengths(freqs, maxCodeLength);
+    }
+    vector<BitCode> huffmanCodes = generateCodes(codeLengths);
+
+    // 显示哈夫曼编码
+    displayHuffmanCodes(keywords, huffmanCodes, 100);//100，最多显示100个
+
+    // 分析压缩效果
+    analyzeCompression(keywords, freqs, huffmanCodes, optimalLengths);
+
+    // 实际编码、写文件、解码
+    runRealCompression(keywords, freqs, huffmanCodes, compressedPath);
+
+    printMemoryReport(keywords, tree);
+
+    if (!statsPath.empty()) {
+        // 码长即叶子在（限制码长后的）哈夫曼树中的深度
+        vector<uint64_t> lengthCounts(*max_element(codeLengths.begin(), codeLengths.end()) + 1, 0);
+        for (int length : codeLengths) lengthCounts[length]++;
+        statsCounter("huffman.keywords") = keywords.size();
+        statsCounter("huffman.tree_nodes") = tree.nodes.size();
+        statsHistogram("huffman.code_length", lengthCounts);
+        if (!writeStatsJSON(statsPath)) {
+            cerr << "无法写入统计文件: " << statsPath << endl;
+            return 1;
+        }
+    }
+
+    // 哈夫曼树的节点和关键词随tree一起释放
+
+    return 0;
+}
@@ -0,0 +1,496 @@
+#include "huffman.h"
+#include "keyword_table_file.h"
+#include "stats.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <queue>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+using namespace std;
+
+// 读取CSV文件
+bool readCSV(const string& filename, vector<string>& keywords, vector<int>& freqs, vector<double>& novelties) {
+    STATS_TIMER("huffman.read_csv");
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << "错误: 无法打开文件 " << filename << endl;
+        return false;
+    }
+
+    string line;
+    // 跳过表头
+    getline(file, line);
+
+    // 读取数据
+    while (getline(file, line)) {
+        stringstream ss(line);
+        string keyword, freqStr, noveltyStr;
+
+        // 读取三列数据
+        getline(ss, keyword, ',');
+        getline(ss, freqStr, ',');
+        getline(ss, noveltyStr, ',');
+
+        if (!keyword.empty() && !freqStr.empty()) {
+            keywords.push_back(keyword);
+            freqs.push_back(stoi(freqStr));
+            if (!noveltyStr.empty()) {
+                novelties.push_back(stod(noveltyStr));
+            }
+        }
+    }
+
+    file.close();
+    return true;
+}
+
+// 读取二进制统计表
+bool readKeywordTable(const string& filename, vector<string>& keywords, vector<int>& freqs, vector<double>& novelties) {
+    STATS_TIMER("huffman.read_table");
+    KeywordTableFile table;
+    if (!table.open(filename)) {
+        cerr << "错误: 无法打开或校验二进制统计表 " << filename << endl;
+        return false;
+    }
+
+    keywords.reserve(keywords.size() + table.size());
+    for (size_t i = 0; i < table.size(); i++) {
+        keywords.emplace_back(table.keyword(i));
+        freqs.push_back(table.freq(i));
+        novelties.push_back(table.avgNovelty(i));
+    }
+    return true;
+}
+
+// 构建哈夫曼树
+HuffmanTree buildHuffmanTree(const vector<string>& keywords, const vector<int>& freqs) {
+    STATS_TIMER("huffman.build_tree");
+    HuffmanTree tree;
+    tree.nodes.reserve(keywords.empty() ? 0 : 2 * keywords.size() - 1);  // n个叶子的哈夫曼树共2n-1个节点
+    size_t arenaBytes = 0;
+    for (const string& kw : keywords) arenaBytes += kw.length();
+    tree.keywordArena.reserve(arenaBytes);
+
+    // 创建优先队列（小顶堆）
+    priority_queue<uint32_t, vector<uint32_t>, CompareNode> pq(CompareNode{&tree});
+
+    // 为每个关键词创建叶子节点并加入优先队列
+    for (size_t i = 0; i < keywords.size(); i++) {
+        pq.push(tree.addLeaf(keywords[i], freqs[i]));
+    }
+
+    // 构建哈夫曼树
+    while (pq.size() > 1) {
+        // 取出两个最小权值的节点
+        uint32_t left = pq.top();
+        pq.pop();
+        uint32_t right = pq.top();
+        pq.pop();
+
+        // 合并为新节点，并插回优先队列
+        pq.push(tree.addParent(left, right));
+    }
+
+    // 记录根节点
+    tree.root = pq.empty() ? NO_NODE : pq.top();
+    return tree;
+}
+
+// 按频率升序排列的关键词下标：LSD基数排序（每趟11位，共3趟），稳定且为O(n)
+vector<uint32_t> radixSortByFreq(const vector<int>& freqs) {
+    size_t n = freqs.size();
+    vector<uint32_t> order(n), buffer(n);
+    for (uint32_t i = 0; i < n; i++) order[i] = i;
+
+    for (int shift = 0; shift < 32; shift += 11) {
+        size_t count[2048 + 1] = {0};
+        for (uint32_t symbol : order) {
+            count[(((uint32_t)freqs[symbol] >> shift) & 2047) + 1]++;
+        }
+        for (int d = 0; d < 2048; d++) count[d + 1] += count[d];
+        for (uint32_t symbol : order) {
+            buffer[count[((uint32_t)freqs[symbol] >> shift) & 2047]++] = symbol;
+        }
+        order.swap(buffer);
+    }
+    return order;
+}
+
+// 线性时间构建哈夫曼树（双队列归并）：叶子按频率排好序作为第一个队列；
+// 合并出的内部节点权值单调不减，按生成顺序追加在节点池末尾，本身就是第二个队列。
+// 每步只需比较两个队首，不需要堆，也不单独申请节点
+HuffmanTree buildHuffmanTreeLinear(const vector<string>& keywords, const vector<int>& freqs) {
+    STATS_TIMER("huffman.build_tree_linear");
+    HuffmanTree tree;
+    size_t n = keywords.size();
+    if (n == 0) return tree;
+
+    tree.nodes.reserve(2 * n - 1);
+    size_t arenaBytes = 0;
+    for (const string& kw : keywords) arenaBytes += kw.length();
+    tree.keywordArena.reserve(arenaBytes);
+    for (size_t i = 0; i < n; i++) {
+        tree.addLeaf(keywords[i], freqs[i]);
+    }
+
+    vector<uint32_t> leaves = radixSortByFreq(freqs);
+    size_t leafHead = 0;
+    uint32_t internalHead = (uint32_t)n;
+    auto takeMin = [&]() -> uint32_t {
+        if (leafHead < n && (internalHead == tree.nodes.size() ||
+                             tree.nodes[leaves[leafHead]].freq <= tree.nodes[internalHead].freq)) {
+            return leaves[leafHead++];
+        }
+        return internalHead++;
+    };
+
+    for (size_t merges = 1; merges < n; merges++) {
+        uint32_t left = takeMin();
+        uint32_t right = takeMin();
+        tree.addParent(left, right);
+    }
+
+    tree.root = (uint32_t)tree.nodes.size() - 1;
+    return tree;
+}
+
+// 各关键词在哈夫曼树中的深度（即最优码长）。叶子按关键词顺序最先加入节点池，所以叶子下标就是关键词下标
+vector<int> computeCodeLengths(const HuffmanTree& tree, size_t keywordCount) {
+    STATS_TIMER("huffman.code_lengths");
+    vector<int> lengths(keywordCount, 0);
+    if (tree.root == NO_NODE) return lengths;
+
+    vector<pair<uint32_t, int>> stack = {{tree.root, 0}};
+    while (!stack.empty()) {
+        uint32_t node = stack.back().first;
+        int depth = stack.back().second;
+        stack.pop_back();
+        if (tree.isLeaf(node)) {
+            lengths[node] = max(depth, 1);  // 特殊情况：只有一个节点时编码为1位
+        } else {
+            stack.push_back({tree.nodes[node].left, depth + 1});
+            stack.push_back({tree.nodes[node].right, depth + 1});
+        }
+    }
+    return lengths;
+}
+
+// 限制最大码长的最优码长（package-merge算法）。
+// 从最深一层开始，每层列表 = 全部叶子 与 上一层列表两两打包 按权值归并；最后在第1层取前2n-2项，
+// 每个符号的码长等于它在各层被选中的次数。只记录每层列表里各项是不是叶子，不展开包的内容。
+// 要求 n <= 2^maxLength
+vector<int> limitCodeLengths(const vector<int>& freqs, int maxLength) {
+    STATS_TIMER("huffman.limit_code_lengths");
+    size_t n = freqs.size();
+    // maxLength位最多只能给2^maxLength个符号分配前缀码，再多时得到的码长会违反Kraft不等式
+    if (n > 0 && (maxLength < 1 || (maxLength < 64 && n > (1ull << maxLength)))) {
+        throw invalid_argument("码长限制 " + to_string(maxLength) + " 位不足以容纳 " + to_string(n) + " 个关键词");
+    }
+    vector<int> lengths(n, 0);
+    if (n == 0) return lengths;
+    if (n == 1) {
+        lengths[0] = 1;
+        return lengths;
+    }
+
+    vector<uint32_t> order(n);  // 按频率升序的符号
+    for (uint32_t i = 0; i < n; i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return freqs[a] < freqs[b]; });
+
+    vector<vector<uint8_t>> isLeaf(maxLength);  // isLeaf[0]是最深一层
+    vector<uint64_t> previous, current;
+    for (int level = 0; level < maxLength; level++) {
+        current.clear();
+        size_t leaf = 0, package = 0;
+        size_t packageCount = previous.size() / 2;
+        while (leaf < n || package < packageCount) {
+            uint64_t packageWeight = package < packageCount ? previous[2 * package] + previous[2 * package + 1] : 0;
+            if (package == packageCount || (leaf < n && (uint64_t)freqs[order[leaf]] <= packageWeight)) {
+                current.push_back(freqs[order[leaf++]]);
+                isLeaf[level].push_back(1);
+            } else {
+                current.push_back(packageWeight);
+                package++;
+                isLeaf[level].push_back(0);
+            }
+        }
+        previous.swap(current);
+    }
+
+    size_t take = 2 * n - 2;
+    for (int level = maxLength - 1; level >= 0 && take > 0; level--) {
+        size_t leaves = 0;
+        for (size_t i = 0; i < take; i++) leaves += isLeaf[level][i];
+        for (size_t i = 0; i < leaves; i++) lengths[order[i]]++;
+        take = 2 * (take - leaves);  // 选中的包来自下一层的前2倍项
+    }
+    return lengths;
+}
+
+// 由码长生成范式哈夫曼编码：码长相同的关键词按下标顺序分配连续的编码，所以只需要码长就能重建码表
+vector<BitCode> generateCodes(const vector<int>& lengths) {
+    STATS_TIMER("huffman.generate_codes");
+    int maxLength = 0;
+    for (int length : lengths) maxLength = max(maxLength, length);
+
+    vector<uint64_t> lengthCount(maxLength + 1, 0);
+    for (int length : lengths) {
+        if (length > 0) lengthCount[length]++;
+    }
+
+    vector<uint64_t> nextCode(maxLength + 1, 0);
+    uint64_t code = 0;
+    for (int length = 1; length <= maxLength; length++) {
+        code = (code + lengthCount[length - 1]) << 1;
+        nextCode[length] = code;
+    }
+
+    vector<BitCode> codes(lengths.size(), BitCode{0, 0});
+    for (size_t i = 0; i < lengths.size(); i++) {
+        if (lengths[i] > 0) {
+            codes[i] = {nextCode[lengths[i]]++, lengths[i]};
+        }
+    }
+    return codes;
+}
+
+// 编码的文本形式（仅用于显示）
+string codeToString(const BitCode& code) {
+    string text;
+    for (int i = code.length - 1; i >= 0; i--) {
+        text += ((code.bits >> i) & 1) ? '1' : '0';
+    }
+    return text;
+}
+
+// 计算编码效果并分析压缩率；optimalLengths是不限码长时的最优码长，用于计算长度限制带来的损失
+void analyzeCompression(const vector<string>& keywords, const vector<int>& freqs,
+                        const vector<BitCode>& huffmanCodes, const vector<int>& optimalLengths) {
+    int N = keywords.size(); // 关键词数量
+
+    // 1. 定长编码
+    int fixedBitsPerKeyword = ceil(log2(N));
+    if (fixedBitsPerKeyword == 0) fixedBitsPerKeyword = 1; // 至少1位
+
+    long long totalFreq = 0; // 总频率（所有关键词出现次数之和）
+    for (int f : freqs) {
+        totalFreq += f;
+    }
+
+    long long fixedTotalBits = totalFreq * fixedBitsPerKeyword;
+
+    // 2. 哈夫曼编码
+    long long huffmanTotalBits = 0;
+    long long optimalTotalBits = 0;
+    int maxCodeLength = 0;
+    for (size_t i = 0; i < keywords.size(); i++) {
+        int freq = freqs[i];
+        huffmanTotalBits += (long long)freq * huffmanCodes[i].length;
+        optimalTotalBits += (long long)freq * optimalLengths[i];
+        maxCodeLength = max(maxCodeLength, huffmanCodes[i].length);
+    }
+
+    // 3. 计算压缩率
+    double compressionRatio = (double)huffmanTotalBits / fixedTotalBits;
+
+    // 输出结果
+    cout << "\n========== 两种编码对比 ==========" << endl;
+    cout << "关键词总数 (N): " << N << endl;
+    cout << "关键词总出现次数: " << totalFreq << endl;
+    cout << "\n【定长编码】" << endl;
+    cout << "  总比特数: " << fixedTotalBits << " bits" << endl;
+    cout << "  每个关键词位数: " << fixedBitsPerKeyword << " bits" << endl;
+    cout << "\n【哈夫曼编码】" << endl;
+    cout << "  总比特数: " << huffmanTotalBits << " bits" << endl;
+    double avgCodeLength = (double)huffmanTotalBits / totalFreq;// 计算平均编码长度
+    cout << "  平均编码长度: " << avgCodeLength << " bits" << endl;
+    cout << "  压缩率 (Compression Ratio): " << compressionRatio << endl;
+    cout << "  最大码长: " << maxCodeLength << " bits" << endl;
+    cout << "  码长限制带来的损失: " << (huffmanTotalBits - optimalTotalBits) << " bits（"
+         << 100.0 * (huffmanTotalBits - optimalTotalBits) / optimalTotalBits << "%，不限码长时为 "
+         << optimalTotalBits << " bits）" << endl;
+}
+
+// 显示哈夫曼编码
+void displayHuffmanCodes(const vector<string>& keywords, const vector<BitCode>& codes, int maxDisplay) {
+    cout << "\n========== 哈夫曼编码 ==========" << endl;
+    cout << "显示 " << min((int)codes.size(), maxDisplay) << " 个关键词的编码:" << endl;
+
+    int count = 0;
+    for (size_t i = 0; i < codes.size(); i++) {
+        if (count >= maxDisplay) break;
+        cout << "  " << keywords[i] << " -> " << codeToString(codes[i]) << endl;
+        count++;
+    }
+
+    if ((int)codes.size() > maxDisplay) {
+        cout << "  ... (还有 " << (codes.size() - maxDisplay) << " 个关键词)" << endl;
+    }
+}
+// 把关键词下标序列编码为比特流，返回写入的比特数
+uint64_t encodeSymbols(const vector<uint32_t>& symbols, const vector<BitCode>& table, vector<uint8_t>& payload) {
+    STATS_TIMER("huffman.encode");
+    BitWriter writer(payload);
+    for (uint32_t symbol : symbols) {
+        writer.write(table[symbol].bits, table[symbol].length);
+    }
+    writer.flush();
+    STATS_COUNT("huffman.encode.symbols", symbols.size());
+    STATS_COUNT("huffman.encode.bits", writer.bitsWritten());
+    return writer.bitsWritten();
+}
+
+// 按码表重建解码树，逐位沿树下降解出symbolCount个关键词下标
+bool decodeSymbols(const vector<uint8_t>& payload, uint64_t symbolCount, const vector<BitCode>& table,
+                   vector<uint32_t>& symbols) {
+    STATS_TIMER("huffman.decode");
+    // 解码树节点：child[0]/child[1]为子节点下标，叶子的symbol为关键词下标
+    struct DecodeNode {
+        uint32_t child[2] = {NO_NODE, NO_NODE};
+        uint32_t symbol = NO_NODE;
+    };
+    vector<DecodeNode> trie(1);
+    for (uint32_t symbol = 0; symbol < table.size(); symbol++) {
+        uint32_t node = 0;
+        for (int i = table[symbol].length - 1; i >= 0; i--) {
+            int bit = (table[symbol].bits >> i) & 1;
+            if (trie[node].child[bit] == NO_NODE) {
+                trie[node].child[bit] = (uint32_t)trie.size();
+                trie.emplace_back();
+            }
+            node = trie[node].child[bit];
+        }
+        trie[node].symbol = symbol;
+    }
+
+    symbols.clear();
+    symbols.reserve(min<uint64_t>(symbolCount, payload.size() * 8));  // 每个关键词至少1位，不按未经检查的数量分配
+    uint32_t node = 0;
+    for (size_t byte = 0; byte < payload.size() && symbols.size() < symbolCount; byte++) {
+        for (int i = 7; i >= 0 && symbols.size() < symbolCount; i--) {
+            node = trie[node].child[(payload[byte] >> i) & 1];
+            if (node == NO_NODE) return false;  // 码流与码表不匹配
+            if (trie[node].symbol != NO_NODE) {
+                symbols.push_back(trie[node].symbol);
+                node = 0;
+            }
+        }
+    }
+    return symbols.size() == symbolCount;
+}
+
+void writeLE(ostream& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out.put((char)((value >> (8 * i)) & 0xFF));
+    }
+}
+
+bool readLE(istream& in, uint64_t& value, int bytes) {
+    value = 0;
+    for (int i = 0; i < bytes; i++) {
+        int c = in.get();
+        if (c == EOF) return false;
+        value |= (uint64_t)(unsigned char)c << (8 * i);
+    }
+    return true;
+}
+
+bool writeCompressedFile(const string& path, const vector<string>& keywords, const vector<BitCode>& table,
+                         uint64_t symbolCount, uint64_t bitCount, const vector<uint8_t>& payload) {
+    // 关键词数是32位、关键词长度是16位，码长不能超过读取时接受的上限，写不下时不生成文件
+    if (keywords.size() > 0xFFFFFFFFu || table.size() != keywords.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < keywords.size(); i++) {
+        if (keywords[i].length() > 0xFFFF || table[i].length > DEFAULT_MAX_CODE_LENGTH) {
+            return false;
+        }
+    }
+
+    ofstream out(path, ios::binary);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    out.write(HUFFMAN_FILE_MAGIC, 4);
+    writeLE(out, HUFFMAN_FILE_VERSION, 1);
+    writeLE(out, keywords.size(), 4);
+    for (size_t i = 0; i < keywords.size(); i++) {
+        writeLE(out, keywords[i].length(), 2);
+        out.write(keywords[i].data(), keywords[i].length());
+        writeLE(out, table[i].length, 1);
+    }
+    writeLE(out, symbolCount, 8);
+    writeLE(out, bitCount, 8);
+    out.write((const char*)payload.data(), payload.size());
+    return (bool)out;
+}
+
+bool readCompressedFile(const string& path, vector<string>& keywords, vector<BitCode>& table,
+                        uint64_t& symbolCount, uint64_t& bitCount, vector<uint8_t>& payload) {
+    ifstream in(path, ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+
+    // 表头里的数量都先与文件剩余的字节数核对，损坏的文件不会导致按巨大的数量分配内存
+    in.seekg(0, ios::end);
+    uint64_t remaining = (uint64_t)in.tellg();
+    in.seekg(0);
+
+    char magic[4];
+    uint64_t version, count;
+    if (!in.read(magic, 4) || !equal(magic, magic + 4, HUFFMAN_FILE_MAGIC) ||
+        !readLE(in, version, 1) || version != HUFFMAN_FILE_VERSION || !readLE(in, count, 4)) {
+        return false;
+    }
+    remaining -= 9;
+
+    // 每个关键词至少占3字节（长度和码长），码表之后还有16字节的出现次数和比特数
+    if (remaining < 16 || count > (remaining - 16) / 3) {
+        return false;
+    }
+    keywords.assign(count, "");
+    vector<int> lengths(count, 0);
+    uint64_t kraftSum = 0;  // Σ 2^(最大码长-码长)，前缀码要求不超过 2^最大码长
+    int minLength = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t length, codeLength;
+        if (!readLE(in, length, 2) || length + 3 > remaining) return false;
+        keywords[i].resize(length);
+        if (!in.read(&keywords[i][0], length) || !readLE(in, codeLength, 1) || codeLength > DEFAULT_MAX_CODE_LENGTH) return false;
+        remaining -= length + 3;
+        lengths[i] = (int)codeLength;
+        if (codeLength > 0) {
+            kraftSum += 1ull << (DEFAULT_MAX_CODE_LENGTH - codeLength);
+            if (kraftSum > 1ull << DEFAULT_MAX_CODE_LENGTH) return false;
+            minLength = minLength == 0 ? (int)codeLength : min(minLength, (int)codeLength);
+        }
+    }
+    table = generateCodes(lengths);
+
+    if (remaining < 16 || !readLE(in, symbolCount, 8) || !readLE(in, bitCount, 8)) {
+        return false;
+    }
+    remaining -= 16;
+    // 负载不能超出文件末尾，每个关键词至少占最短码长的位数
+    uint64_t payloadBytes = bitCount / 8 + (bitCount % 8 != 0);
+    if (payloadBytes > remaining || (symbolCount > 0 && (minLength == 0 || symbolCount > bitCount / minLength))) {
+        return false;
+    }
+    payload.resize(payloadBytes);
+    return (bool)in.read((char*)payload.data(), payload.size());
+}
+
+// 生成关键词出现序列：每个关键词按其频率出现，顺序打乱（固定种子）
+vector<uint32_t> sampleOccurrences(const vector<int>& freqs) {
+    vector<uint32_t> symbols;
+    for (uint32_t i = 0; i < freqs.size(); i++) {
+        symbols.insert(symbols.end(), freqs[i], i);
+    }
+    shuffle(symbols.begin(), symbols.end(), mt19937(2024));
+    return symbols;
+}
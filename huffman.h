@@ -0,0 +1,286 @@
+#ifndef HUFFMAN_H
+#define HUFFMAN_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iosfwd>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+// 关键词哈夫曼编码：建树、码长限制、范式编码、比特流编码/解码与压缩文件读写
+
+// 哈夫曼树节点结构：所有节点放在同一个数组里，子节点用32位下标表示
+const uint32_t NO_NODE = 0xFFFFFFFFu;
+
+struct HuffmanNode {
+    uint32_t keywordOffset;  // 关键词在字符串区中的位置（只有叶子节点有）
+    uint32_t keywordLength;
+    int freq;                // 频率（权值）
+    uint32_t left;           // 左子节点下标
+    uint32_t right;          // 右子节点下标
+};
+
+// 哈夫曼树：节点池 + 共享字符串区，整棵树随对象一次性释放
+struct HuffmanTree {
+    std::vector<HuffmanNode> nodes;
+    std::string keywordArena;
+    uint32_t root = NO_NODE;
+
+    uint32_t addLeaf(const std::string& kw, int f) {
+        nodes.push_back({(uint32_t)keywordArena.size(), (uint32_t)kw.length(), f, NO_NODE, NO_NODE});
+        keywordArena += kw;
+        return (uint32_t)nodes.size() - 1;
+    }
+
+    uint32_t addParent(uint32_t left, uint32_t right) {
+        nodes.push_back({0, 0, nodes[left].freq + nodes[right].freq, left, right});
+        return (uint32_t)nodes.size() - 1;
+    }
+
+    bool isLeaf(uint32_t index) const {
+        return nodes[index].left == NO_NODE && nodes[index].right == NO_NODE;
+    }
+
+    std::string_view keyword(uint32_t index) const {
+        return std::string_view(keywordArena.data() + nodes[index].keywordOffset, nodes[index].keywordLength);
+    }
+};
+
+// 优先队列的比较器（小顶堆）
+struct CompareNode {
+    const HuffmanTree* tree;
+    bool operator()(uint32_t a, uint32_t b) const {
+        return tree->nodes[a].freq > tree->nodes[b].freq; // 频率小的优先级高
+    }
+};
+
+// 默认最大码长：编码不超过24位，解码时可以整体装进一个32位的窗口
+const int DEFAULT_MAX_CODE_LENGTH = 24;
+
+// 读取关键词统计表（keyword,freq,avg_novelty）
+bool readCSV(const std::string& filename, std::vector<std::string>& keywords, std::vector<int>& freqs, std::vector<double>& novelties);
+
+// 读取二进制统计表（.kwtb，映射后直接取各列，不解析文本）
+bool readKeywordTable(const std::string& filename, std::vector<std::string>& keywords, std::vector<int>& freqs, std::vector<double>& novelties);
+
+// 构建哈夫曼树（优先队列）
+HuffmanTree buildHuffmanTree(const std::vector<std::string>& keywords, const std::vector<int>& freqs);
+
+// 一个关键词的二进制编码：bits的低length位，按从高位到低位的顺序写出
+struct BitCode {
+    uint64_t bits;
+    int length;
+};
+
+// 按频率升序排列的关键词下标：LSD基数排序，稳定且为O(n)
+std::vector<uint32_t> radixSortByFreq(const std::vector<int>& freqs);
+
+// 线性时间构建哈夫曼树（双队列归并），总码长与优先队列版本相同
+HuffmanTree buildHuffmanTreeLinear(const std::vector<std::string>& keywords, const std::vector<int>& freqs);
+
+// 各关键词在哈夫曼树中的深度（即最优码长）
+std::vector<int> computeCodeLengths(const HuffmanTree& tree, size_t keywordCount);
+
+// 限制最大码长的最优码长（package-merge算法），要求 n <= 2^maxLength，否则抛出std::invalid_argument
+std::vector<int> limitCodeLengths(const std::vector<int>& freqs, int maxLength);
+
+// 由码长生成范式哈夫曼编码
+std::vector<BitCode> generateCodes(const std::vector<int>& lengths);
+
+// 编码的文本形式（仅用于显示）
+std::string codeToString(const BitCode& code);
+
+// 计算编码效果并分析压缩率；optimalLengths是不限码长时的最优码长，用于计算长度限制带来的损失
+void analyzeCompression(const std::vector<std::string>& keywords, const std::vector<int>& freqs,
+                        const std::vector<BitCode>& huffmanCodes, const std::vector<int>& optimalLengths);
+
+// 显示哈夫曼编码
+void displayHuffmanCodes(const std::vector<std::string>& keywords, const std::vector<BitCode>& codes, int maxDisplay = 20);
+
+// ========== 比特流编码/解码 ==========
+
+// 按位写入字节缓冲区（高位在前），凑满8位输出一个字节
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    void write(uint64_t bits, int length) {
+        while (length > 0) {
+            int take = std::min(length, 56 - pending);  // 保证累加器不溢出
+            length -= take;
+            accumulator = (accumulator << take) | ((bits >> length) & ((1ULL << take) - 1));
+            pending += take;
+            while (pending >= 8) {
+                pending -= 8;
+                out.push_back((uint8_t)(accumulator >> pending));
+            }
+            bitCount += take;
+        }
+    }
+
+    // 把最后不足8位的部分补0写出
+    void flush() {
+        if (pending > 0) {
+            out.push_back((uint8_t)(accumulator << (8 - pending)));
+            pending = 0;
+        }
+        accumulator = 0;
+    }
+
+    uint64_t bitsWritten() const { return bitCount; }
+
+private:
+    std::vector<uint8_t>& out;
+    uint64_t accumulator = 0;
+    int pending = 0;
+    uint64_t bitCount = 0;
+};
+
+// 把关键词下标序列编码为比特流，返回写入的比特数
+uint64_t encodeSymbols(const std::vector<uint32_t>& symbols, const std::vector<BitCode>& table, std::vector<uint8_t>& payload);
+
+// 按码表重建解码树，逐位沿树下降解出symbolCount个关键词下标
+bool decodeSymbols(const std::vector<uint8_t>& payload, uint64_t symbolCount, const std::vector<BitCode>& table,
+                   std::vector<uint32_t>& symbols);
+
+// 查表解码器：用接下来的11位查一级表，一次解出1~2个短编码；更长的编码在一级表中指向二级子表。
+// 一级表2048项、每项12字节，可以常驻L1缓存。要求最大码长不超过32位
+class TableDecoder {
+public:
+    static const int PRIMARY_BITS = 11;
+    static const int MAX_CODE_LENGTH = 32;
+
+    bool build(const std::vector<BitCode>& codes) {
+        const uint32_t primarySize = 1u << PRIMARY_BITS;
+        primary.assign(primarySize, Entry{{0, 0}, INVALID, 0, 0});
+        secondary.clear();
+
+        // 短编码：填满以该编码为前缀的所有一级表项
+        std::vector<int> subBits(primarySize, 0);
+        for (uint32_t symbol = 0; symbol < codes.size(); symbol++) {
+            int length = codes[symbol].length;
+            if (length > MAX_CODE_LENGTH) return false;
+            if (length == 0) continue;
+            if (length <= PRIMARY_BITS) {
+                uint32_t start = (uint32_t)codes[symbol].bits << (PRIMARY_BITS - length);
+                for (uint32_t i = 0; i < (1u << (PRIMARY_BITS - length)); i++) {
+                    primary[start + i] = Entry{{symbol, 0}, 1, (uint8_t)length, (uint8_t)length};
+                }
+            } else {
+                uint32_t prefix = (uint32_t)(codes[symbol].bits >> (length - PRIMARY_BITS));
+                subBits[prefix] = std::max(subBits[prefix], length - PRIMARY_BITS);
+            }
+        }
+
+        // 长编码：每个11位前缀一张子表，子表按该前缀下最长编码的剩余位数索引
+        for (uint32_t prefix = 0; prefix < primarySize; prefix++) {
+            if (subBits[prefix] > 0) {
+                primary[prefix] = Entry{{(uint32_t)secondary.size(), 0}, SUBTABLE, (uint8_t)subBits[prefix], 0};
+                secondary.resize(secondary.size() + (1u << subBits[prefix]), Entry{{0, 0}, INVALID, 0, 0});
+            }
+        }
+        for (uint32_t symbol = 0; symbol < codes.size(); symbol++) {
+            int length = codes[symbol].length;
+            if (length <= PRIMARY_BITS) continue;
+            int rest = length - PRIMARY_BITS;
+            uint32_t prefix = (uint32_t)(codes[symbol].bits >> rest);
+            const Entry& table = primary[prefix];
+            uint32_t start = table.symbol[0] + ((uint32_t)(codes[symbol].bits & ((1ULL << rest) - 1)) << (table.bits - rest));
+            for (uint32_t i = 0; i < (1u << (table.bits - rest)); i++) {
+                secondary[start + i] = Entry{{symbol, 0}, 1, (uint8_t)rest, (uint8_t)rest};
+            }
+        }
+
+        // 短编码之后剩下的位如果恰好还能完整装下一个短编码，就把它也放进同一项
+        for (uint32_t index = 0; index < primarySize; index++) {
+            Entry& entry = primary[index];
+            if (entry.count != 1 || entry.bits >= PRIMARY_BITS) continue;
+            const Entry& next = primary[(index << entry.bits) & (primarySize - 1)];
+            if ((next.count == 1 || next.count == 2) && next.firstBits <= PRIMARY_BITS - entry.bits) {
+                entry.symbol[1] = next.symbol[0];
+                entry.count = 2;
+                entry.bits = entry.firstBits + next.firstBits;
+            }
+        }
+        return true;
+    }
+
+    bool decode(const std::vector<uint8_t>& payload, uint64_t symbolCount, std::vector<uint32_t>& symbols) const {
+        if (symbolCount > payload.size() * 8) return false;  // 每个关键词至少1位
+        symbols.resize(symbolCount);
+        uint64_t buffer = 0;  // 待解码的位，左对齐
+        int available = 0;
+        size_t position = 0;
+        uint64_t consumed = 0;
+
+        uint64_t out = 0;
+        while (out < symbolCount) {
+            // 保证缓冲区里至少有32位，读完负载后补0
+            while (available <= 56) {
+                uint64_t byte = position < payload.size() ? payload[position] : 0;
+                position++;
+                buffer |= byte << (56 - available);
+                available += 8;
+            }
+
+            const Entry& entry = primary[buffer >> (64 - PRIMARY_BITS)];
+            int bits;
+            if (entry.count == 2 && out + 1 < symbolCount) {
+                symbols[out++] = entry.symbol[0];
+                symbols[out++] = entry.symbol[1];
+                bits = entry.bits;
+            } else if (entry.count == 1 || entry.count == 2) {
+                symbols[out++] = entry.symbol[0];
+                bits = entry.firstBits;
+            } else if (entry.count == SUBTABLE) {
+                const Entry& sub = secondary[entry.symbol[0] + ((buffer << PRIMARY_BITS) >> (64 - entry.bits))];
+                if (sub.count != 1) return false;
+                symbols[out++] = sub.symbol[0];
+                bits = PRIMARY_BITS + sub.bits;
+            } else {
+                return false;  // 码流与码表不匹配
+            }
+            buffer <<= bits;
+            available -= bits;
+            consumed += bits;
+        }
+        return consumed <= payload.size() * 8;
+    }
+
+private:
+    static const uint8_t INVALID = 0;
+    static const uint8_t SUBTABLE = 3;
+
+    struct Entry {
+        uint32_t symbol[2];  // 解出的关键词下标；子表项的symbol[0]为子表在secondary中的起点
+        uint8_t count;       // 1/2：本项解出的关键词个数；SUBTABLE：指向子表；INVALID：非法前缀
+        uint8_t bits;        // 消耗的总位数；子表项为子表的索引位数
+        uint8_t firstBits;   // 第一个关键词的码长
+    };
+
+    std::vector<Entry> primary;
+    std::vector<Entry> secondary;
+};
+
+// 压缩文件格式（整数均为小端序）：
+//   "KWHF" 版本号(u8)
+//   关键词数(u32)，之后每个关键词：长度(u16) 字节 码长(u8)——范式编码只需码长即可重建码表
+//   关键词出现次数(u64) 负载比特数(u64) 负载字节
+// 码长不超过DEFAULT_MAX_CODE_LENGTH；写入时关键词超过65535字节返回false，读取时各数量与文件大小不符、码长不构成前缀码都返回false
+const char HUFFMAN_FILE_MAGIC[4] = {'K', 'W', 'H', 'F'};
+const uint8_t HUFFMAN_FILE_VERSION = 2;
+
+void writeLE(std::ostream& out, uint64_t value, int bytes);
+bool readLE(std::istream& in, uint64_t& value, int bytes);
+
+bool writeCompressedFile(const std::string& path, const std::vector<std::string>& keywords, const std::vector<BitCode>& table,
+                         uint64_t symbolCount, uint64_t bitCount, const std::vector<uint8_t>& payload);
+bool readCompressedFile(const std::string& path, std::vector<std::string>& keywords, std::vector<BitCode>& table,
+                        uint64_t& symbolCount, uint64_t& bitCount, std::vector<uint8_t>& payload);
+
+// 生成关键词出现序列：每个关键词按其频率出现，顺序打乱（固定种子）
+std::vector<uint32_t> sampleOccurrences(const std::vector<int>& freqs);
+
+#endif
@@ -0,0 +1,399 @@
+#include "keyword_analysis.h"
+#include "csv_scanner.h"
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <charconv>
+#include <thread>
+#include <utility>
+using namespace std;
+
+// 去除字符串首尾空格（返回原字符串上的切片）
+string_view trim(string_view str) {
+    size_t start = 0;
+    size_t end = str.length();
+
+    // 找到第一个非空格字符
+    while (start < end && isspace((unsigned char)str[start])) {
+        start++;
+    }
+
+    // 找到最后一个非空格字符
+    while (end > start && isspace((unsigned char)str[end - 1])) {
+        end--;
+    }
+
+    return str.substr(start, end - start);
+}
+
+// 检查关键词是否有效（不包含特殊字符）
+bool isValidKeyword(string_view keyword) {
+    if (keyword.empty()) {
+        return false;
+    }
+
+    // 检查是否包含中括号、引号、逗号等特殊字符
+    for (char c : keyword) {
+        if (c == '[' || c == ']' || c == '"' || c == '\'' || c == '\\' || c == ',') {
+            return false;
+        }
+    }
+
+    // 检查是否只是空格
+    bool hasNonSpace = false;
+    for (char c : keyword) {
+        if (!isspace((unsigned char)c)) {
+            hasNonSpace = true;
+            break;
+        }
+    }
+
+    return hasNonSpace;
+}
+
+// 解析Keywords字段，提取所有关键词（结果是keywordField上的切片）
+void parseKeywords(string_view keywordField, vector<string_view>& keywords) {
+    keywords.clear();
+    size_t start = 0;
+    bool inQuote = false;
+
+    for (size_t i = 0; i < keywordField.length(); i++) {
+        if (keywordField[i] == '"') {
+            inQuote = !inQuote;
+            if (inQuote) {
+                start = i + 1;
+            } else if (i > start) {
+                // 当引号关闭时，保存当前关键词（去除空格）
+                string_view trimmed = trim(keywordField.substr(start, i - start));
+                if (!trimmed.empty()) {
+                    keywords.push_back(trimmed);
+                }
+            }
+        }
+    }
+}
+
+// 解析CSV行，处理可能包含逗号的字段（结果是line上的切片）
+void parseCSVLine(string_view line, vector<string_view>& fields) {
+    fields.clear();
+    if (line.empty()) return;
+
+    size_t start = 0;
+    bool inQuote = false;
+    bool inBracket = false;
+
+    for (size_t i = 0; i < line.length(); i++) {
+        char c = line[i];
+
+        if (c == '"') {
+            inQuote = !inQuote;
+        } else if (c == '[') {
+            inBracket = true;
+        } else if (c == ']') {
+            inBracket = false;
+        } else if (c == ',' && !inQuote && !inBracket) {
+            fields.push_back(line.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+
+    // 添加最后一个字段
+    if (start < line.length() || line.back() == ',') {
+        fields.push_back(line.substr(start));
+    }
+}
+
+// 解析浮点数，行为与stod一致：跳过前导空白，允许一个正号，只要求前缀是合法数字。
+// 唯一的区别是from_chars不认十六进制（"0x1p3"之类stod能解析，这里只读出前面的0）
+bool parseDouble(string_view str, double& value) {
+    size_t i = 0;
+    while (i < str.length() && isspace((unsigned char)str[i])) {
+        i++;
+    }
+    // from_chars不接受正号，跳过它；但"+-5"这样正号后面还有负号的stod会拒绝，这里也不跳过
+    if (i + 1 < str.length() && str[i] == '+' && str[i + 1] != '-') {
+        i++;
+    }
+    from_chars_result result = from_chars(str.data() + i, str.data() + str.length(), value);
+    return result.ec == errc();
+}
+
+// 取出data中从pos开始的一行（与getline一致：以\n分行，并去掉Windows换行的\r），pos移到下一行开头
+string_view nextLine(string_view data, size_t& pos) {
+    size_t lineEnd = data.find('\n', pos);
+    if (lineEnd == string_view::npos) lineEnd = data.length();
+    string_view line = data.substr(pos, lineEnd - pos);
+    pos = lineEnd + 1;
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+// 解析一行数据：成功时keywords中是该行的全部关键词，novelty是该行的Novelty
+bool parseRecord(string_view line, vector<string_view>& fields, vector<string_view>& keywords, double& novelty) {
+    parseCSVLine(line, fields);
+
+    // 检查是否有足够的列（至少需要9列）
+    if (fields.size() < 9) {
+        return false;
+    }
+
+    // 第八列是Keywords（索引7），第九列是Novelty（索引8）
+    // 解析Novelty值，如果无法解析，跳过这一行
+    if (!parseDouble(fields[8], novelty)) {
+        return false;
+    }
+
+    parseKeywords(fields[7], keywords);
+    return true;
+}
+
+// 单线程统计body中的所有行
+int aggregateSequential(string_view body, KeywordTable& table) {
+    vector<string_view> fields;
+    vector<string_view> keywords;
+    int lineCount = 0;
+
+    CSVScanner scanner(body);
+    while (!scanner.done()) {
+        lineCount++;
+
+        double novelty = 0.0;
+        if (!scanner.nextRecord(fields, keywords, novelty)) {
+            continue;
+        }
+
+        // 统计每个关键词（只统计有效的关键词）
+        for (string_view keyword : keywords) {
+            if (isValidKeyword(keyword)) {
+                KeywordStats& stats = table.stats(table.findOrInsert(keyword));
+                stats.freq++;
+                stats.noveltySum += novelty;
+            }
+        }
+    }
+    return lineCount;
+}
+
+void aggregateShard(string_view shard, ShardResult& result) {
+    vector<string_view> fields;
+    vector<string_view> keywords;
+
+    CSVScanner scanner(shard);
+    while (!scanner.done()) {
+        result.lineCount++;
+
+        double novelty = 0.0;
+        if (!scanner.nextRecord(fields, keywords, novelty)) {
+            continue;
+        }
+
+        for (string_view keyword : keywords) {
+            if (isValidKeyword(keyword)) {
+                uint32_t id = result.table.findOrInsert(keyword);
+                result.table.stats(id).freq++;
+                result.occurrences.push_back(id);
+            }
+        }
+        result.rowEnds.push_back(result.occurrences.size());
+        result.rowNovelty.push_back(novelty);
+    }
+}
+
+// 在行边界处把body切成至多count个分片。
+// 原程序用getline读取，一条记录总是以\n结束，引号和中括号状态在每行开头都会重置，
+// 所以只要在\n之后切分，每个分片看到的行与单线程完全一致
+vector<string_view> splitShards(string_view body, unsigned count) {
+    vector<string_view> shards;
+    size_t shardStart = 0;
+    for (unsigned t = 1; t <= count && shardStart < body.length(); t++) {
+        size_t shardEnd = body.length();
+        if (t < count) {
+            shardEnd = max(shardStart, body.length() / count * t);
+            size_t newline = body.find('\n', shardEnd);
+            shardEnd = newline == string_view::npos ? body.length() : newline + 1;
+        }
+        shards.push_back(body.substr(shardStart, shardEnd - shardStart));
+        shardStart = shardEnd;
+    }
+    return shards;
+}
+
+int mergeShards(const vector<ShardResult>& results, KeywordTable& table) {
+    int lineCount = 0;
+    vector<uint32_t> globalIds;
+    for (const ShardResult& result : results) {
+        lineCount += result.lineCount;
+
+        // 频次直接相加；记下每个分片内编号对应的全局编号
+        globalIds.resize(result.table.size());
+        for (uint32_t id = 0; id < result.table.size(); id++) {
+            globalIds[id] = table.findOrInsert(result.table.keywordAt(id));
+            table.stats(globalIds[id]).freq += result.table.stats(id).freq;
+        }
+
+        // 按原始顺序重放Novelty累加
+        size_t occurrence = 0;
+        for (size_t row = 0; row < result.rowEnds.size(); row++) {
+            double novelty = result.rowNovelty[row];
+            for (; occurrence < result.rowEnds[row]; occurrence++) {
+                table.stats(globalIds[result.occurrences[occurrence]]).noveltySum += novelty;
+            }
+        }
+    }
+    return lineCount;
+}
+
+// 多线程统计：切分后每个分片一个线程并行解析，再按分片顺序合并
+int aggregateParallel(string_view body, unsigned threadCount, KeywordTable& table) {
+    vector<string_view> shards = splitShards(body, threadCount);
+    vector<ShardResult> results(shards.size());
+    vector<thread> workers;
+    for (size_t i = 0; i < shards.size(); i++) {
+        workers.emplace_back(aggregateShard, shards[i], ref(results[i]));
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    return mergeShards(results, table);
+}
+
+
+uint64_t boundaryHash(string_view data, uint64_t offset) {
+    const uint64_t window = 4096;
+    uint64_t hash = FNV1A64_OFFSET_BASIS;
+    auto mix = [&](uint64_t begin, uint64_t end) { hash = fnv1a64(data.substr(begin, end - begin), hash); };
+    // 开头和末尾各4KB：不读整个已处理部分，也能发现换了文件或改写了文件末尾
+    uint64_t headEnd = min(offset, window);
+    mix(0, headEnd);
+    mix(max(headEnd, offset > window ? offset - window : 0), offset);
+    return hash;
+}
+
+bool canResumeFrom(const AnalysisCheckpoint& checkpoint, string_view data) {
+    uint64_t offset = checkpoint.inputOffset;
+    if (offset == 0 || offset > data.length() || boundaryHash(data, offset) != checkpoint.boundaryHash) {
+        return false;
+    }
+    // 上次的最后一行没有换行符时，追加的内容会接在这一行后面，只能从头统计
+    return data[offset - 1] == '\n' || offset == data.length();
+}
+
+// 检查点文件格式（本机字节序，只供同一台机器上的下一次运行读取）：
+//   "KWCP" 版本号(u32) 输入位置(u64) 边界哈希(u64) 行数(i32) 关键词数(u32)
+//   之后每个关键词：长度(u32) 字节 频次(i32) Novelty总和(f64)
+const char CHECKPOINT_MAGIC[4] = {'K', 'W', 'C', 'P'};
+const uint32_t CHECKPOINT_VERSION = 1;
+
+template <class T>
+void writeCheckpointValue(ostream& out, const T& value) {
+    out.write((const char*)&value, sizeof(value));
+}
+
+template <class T>
+bool readCheckpointValue(istream& in, T& value) {
+    return (bool)in.read((char*)&value, sizeof(value));
+}
+
+bool saveCheckpoint(const string& path, const AnalysisCheckpoint& checkpoint) {
+    // 先写临时文件再改名，中途失败时不会留下半个检查点
+    string temporaryPath = path + ".tmp";
+    {
+        ofstream out(temporaryPath, ios::binary);
+        if (!out.is_open()) {
+            return false;
+        }
+        out.write(CHECKPOINT_MAGIC, 4);
+        writeCheckpointValue(out, CHECKPOINT_VERSION);
+        writeCheckpointValue(out, checkpoint.inputOffset);
+        writeCheckpointValue(out, checkpoint.boundaryHash);
+        writeCheckpointValue(out, checkpoint.lineCount);
+        writeCheckpointValue(out, (uint32_t)checkpoint.table.size());
+        for (uint32_t id = 0; id < checkpoint.table.size(); id++) {
+            string_view keyword = checkpoint.table.keywordAt(id);
+            const KeywordStats& stats = checkpoint.table.stats(id);
+            writeCheckpointValue(out, (uint32_t)keyword.length());
+            out.write(keyword.data(), keyword.length());
+            writeCheckpointValue(out, stats.freq);
+            writeCheckpointValue(out, stats.noveltySum);
+        }
+        if (!out) {
+            return false;
+        }
+    }
+    remove(path.c_str());
+    return rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+bool loadCheckpoint(const string& path, AnalysisCheckpoint& checkpoint) {
+    ifstream in(path, ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+
+    // 先读进局部变量，完整读完才交给调用者：截断或损坏的检查点不会留下一半的状态
+    AnalysisCheckpoint loaded;
+    char magic[4];
+    uint32_t version = 0, count = 0;
+    if (!in.read(magic, 4) || !equal(magic, magic + 4, CHECKPOINT_MAGIC) ||
+        !readCheckpointValue(in, version) || version != CHECKPOINT_VERSION ||
+        !readCheckpointValue(in, loaded.inputOffset) || !readCheckpointValue(in, loaded.boundaryHash) ||
+        !readCheckpointValue(in, loaded.lineCount) || !readCheckpointValue(in, count)) {
+        return false;
+    }
+
+    string keyword;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t length = 0;
+        KeywordStats stats;
+        if (!readCheckpointValue(in, length)) return false;
+        keyword.resize(length);
+        if (!in.read(&keyword[0], length) || !readCheckpointValue(in, stats.freq) ||
+            !readCheckpointValue(in, stats.noveltySum)) {
+            return false;
+        }
+        loaded.table.stats(loaded.table.findOrInsert(keyword)) = stats;
+    }
+    checkpoint = move(loaded);
+    return true;
+}
+
+int writeKeywordDelta(ostream& out, const KeywordTable& oldTable, const KeywordTable& newTable, int minFreq) {
+    struct Change {
+        string_view keyword;
+        const char* action;
+        int freq;
+        double avgNovelty;
+    };
+    vector<Change> changes;
+
+    for (uint32_t id = 0; id < newTable.size(); id++) {
+        const KeywordStats& stats = newTable.stats(id);
+        if (stats.freq < minFreq) continue;
+        string_view keyword = newTable.keywordAt(id);
+        uint32_t oldId = oldTable.find(keyword);
+        const KeywordStats* oldStats = oldId == KeywordTable::NOT_FOUND ? nullptr : &oldTable.stats(oldId);
+        if (oldStats == nullptr || oldStats->freq < minFreq) {
+            changes.push_back({keyword, "insert", stats.freq, stats.noveltySum / stats.freq});
+        } else if (oldStats->freq != stats.freq || oldStats->noveltySum != stats.noveltySum) {
+            changes.push_back({keyword, "update", stats.freq, stats.noveltySum / stats.freq});
+        }
+    }
+    for (uint32_t id = 0; id < oldTable.size(); id++) {
+        const KeywordStats& stats = oldTable.stats(id);
+        if (stats.freq < minFreq) continue;
+        string_view keyword = oldTable.keywordAt(id);
+        uint32_t newId = newTable.find(keyword);
+        if (newId == KeywordTable::NOT_FOUND || newTable.stats(newId).freq < minFreq) {
+            changes.push_back({keyword, "delete", stats.freq, stats.noveltySum / stats.freq});
+        }
+    }
+    sort(changes.begin(), changes.end(), [](const Change& a, const Change& b) { return a.keyword < b.keyword; });
+
+    out << "action,keyword,freq,avg_novelty" << endl;
+    for (const Change& change : changes) {
+        out << change.action << "," << change.keyword << "," << change.freq << "," << change.avgNovelty << endl;
+    }
+    return (int)changes.size();
+}
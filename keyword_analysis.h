@@ -0,0 +1,148 @@
+#ifndef KEYWORD_ANALYSIS_H
+#define KEYWORD_ANALYSIS_H
+
+#include <string>
+#include <string_view>
+#include <iosfwd>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include "mapped_file.h"
+#include "keyword_hash.h"
+
+// DeepPatentAI专利CSV的读取与关键词统计：内存映射、逐行切片解析、开放寻址统计表、多线程分片聚合
+
+// 去除字符串首尾空格（返回原字符串上的切片）
+std::string_view trim(std::string_view str);
+
+// 检查关键词是否有效（不包含特殊字符）
+bool isValidKeyword(std::string_view keyword);
+
+// 解析Keywords字段，提取所有关键词（结果是keywordField上的切片）
+void parseKeywords(std::string_view keywordField, std::vector<std::string_view>& keywords);
+
+// 解析CSV行，处理可能包含逗号的字段（结果是line上的切片）
+void parseCSVLine(std::string_view line, std::vector<std::string_view>& fields);
+
+// 解析浮点数，行为与stod一致（十六进制除外）：跳过前导空白，只要求前缀是合法数字
+bool parseDouble(std::string_view str, double& value);
+
+// 取出data中从pos开始的一行（与getline一致：以\n分行，并去掉Windows换行的\r），pos移到下一行开头
+std::string_view nextLine(std::string_view data, size_t& pos);
+
+// 解析一行数据：成功时keywords中是该行的全部关键词，novelty是该行的Novelty
+bool parseRecord(std::string_view line, std::vector<std::string_view>& fields, std::vector<std::string_view>& keywords, double& novelty);
+
+// 每个关键词的统计量：频次和Novelty总和放在一起，一次查找同时更新
+struct KeywordStats {
+    int freq = 0;
+    double noveltySum = 0.0;
+};
+
+// 关键词统计表：开放寻址（线性探测）哈希表（KeywordHashIndex），关键词字节统一存放在一块连续的字符串区中。
+// 槽位只存哈希值和条目编号，探测时先比哈希再比字符串；条目编号按首次出现顺序分配，可直接当作关键词ID使用
+class KeywordTable {
+public:
+    // 查找关键词，不存在则插入，返回条目编号
+    uint32_t findOrInsert(std::string_view keyword) {
+        uint32_t hash = fnv1a32(keyword);
+        size_t slot = index.probe(keyword, hash, [this](uint32_t id) { return keywordAt(id); });
+        if (index.occupied(slot)) {
+            return index.id(slot);
+        }
+        uint32_t id = (uint32_t)entries.size();
+        entries.push_back({(uint32_t)arena.size(), (uint32_t)keyword.length(), KeywordStats()});
+        arena.append(keyword.data(), keyword.length());
+        index.fill(slot, hash, id, entries.size());
+        return id;
+    }
+
+    static const uint32_t NOT_FOUND = 0xFFFFFFFFu;
+
+    // 只查找不插入，不存在时返回NOT_FOUND
+    uint32_t find(std::string_view keyword) const {
+        size_t slot = index.probe(keyword, fnv1a32(keyword), [this](uint32_t id) { return keywordAt(id); });
+        return index.occupied(slot) ? index.id(slot) : NOT_FOUND;
+    }
+
+    KeywordStats& stats(uint32_t id) { return entries[id].stats; }
+    const KeywordStats& stats(uint32_t id) const { return entries[id].stats; }
+    std::string_view keywordAt(uint32_t id) const {
+        return std::string_view(arena.data() + entries[id].offset, entries[id].length);
+    }
+    size_t size() const { return entries.size(); }
+
+    // 按关键词字典序排列的条目编号（只在输出时排序一次）
+    std::vector<uint32_t> sortedIds() const {
+        std::vector<uint32_t> ids(entries.size());
+        for (uint32_t i = 0; i < ids.size(); i++) ids[i] = i;
+        sort(ids.begin(), ids.end(), [this](uint32_t a, uint32_t b) {
+            return keywordAt(a) < keywordAt(b);
+        });
+        return ids;
+    }
+
+private:
+    struct Entry {
+        uint32_t offset;  // 关键词在arena中的位置
+        uint32_t length;
+        KeywordStats stats;
+    };
+
+    KeywordHashIndex index;
+    std::vector<Entry> entries;
+    std::string arena;
+};
+
+// 单线程统计body中的所有行（用CSVScanner按块扫描，结果与逐行parseRecord相同），返回有效行数
+int aggregateSequential(std::string_view body, KeywordTable& table);
+
+// 一个分片的统计结果。浮点加法不满足结合律，所以各分片不直接求Novelty总和，
+// 而是按行记录，合并时按原始顺序重放，保证结果与单线程逐位相同
+struct ShardResult {
+    int lineCount = 0;
+    KeywordTable table;            // 分片内的频次（noveltySum不使用）
+    std::vector<uint32_t> occurrences;  // 按出现顺序记录的分片内条目编号
+    std::vector<size_t> rowEnds;        // 每个有效行在occurrences中的结束位置
+    std::vector<double> rowNovelty;     // 每个有效行的Novelty
+};
+
+// 在行边界处把body切成至多count个分片
+std::vector<std::string_view> splitShards(std::string_view body, unsigned count);
+
+// 统计一个分片（多线程统计的工作函数）
+void aggregateShard(std::string_view shard, ShardResult& result);
+
+// 按分片顺序把各分片的结果合并进table，返回总行数。Novelty按原始顺序逐次重放，
+// 代价与关键词出现总次数成正比且是串行的；benchmark按线程数分别给出它占多线程统计的比例
+int mergeShards(const std::vector<ShardResult>& results, KeywordTable& table);
+
+// 多线程统计：在行边界处切分、并行解析、按分片顺序合并，结果与单线程逐位相同
+int aggregateParallel(std::string_view body, unsigned threadCount, KeywordTable& table);
+
+// 增量统计的检查点：已处理到的输入字节位置、已处理的行数和全部关键词的频次与Novelty总和。
+// 下次运行时只统计inputOffset之后新追加的部分，在检查点的统计量上继续累加，
+// 累加顺序与从头统计相同，所以结果逐位一致
+struct AnalysisCheckpoint {
+    uint64_t inputOffset = 0;
+    uint64_t boundaryHash = 0;  // 已处理部分开头和末尾各4KB的哈希，用来确认输入文件只是在末尾追加了数据
+    int lineCount = 0;
+    KeywordTable table;
+};
+
+// data[0, offset)开头和末尾各4KB内容的哈希（中间的改动检查不出来）
+uint64_t boundaryHash(std::string_view data, uint64_t offset);
+
+// 判断检查点能否用于data：offset之前的内容没有变，且上次处理到的位置在行首（或者文件没有变长）
+bool canResumeFrom(const AnalysisCheckpoint& checkpoint, std::string_view data);
+
+bool saveCheckpoint(const std::string& path, const AnalysisCheckpoint& checkpoint);
+// 读取失败（文件不存在、截断或损坏）时返回false，checkpoint保持不变
+bool loadCheckpoint(const std::string& path, AnalysisCheckpoint& checkpoint);
+
+// 比较新旧两张统计表中频次>=minFreq的部分，按关键词字典序写出变化：
+// action,keyword,freq,avg_novelty，action为insert/update/delete（delete给出的是旧值），返回变化条数
+int writeKeywordDelta(std::ostream& out, const KeywordTable& oldTable, const KeywordTable& newTable, int minFreq);
+
+#endif
@@ -0,0 +1,812 @@
+#include "keyword_bst.h"
+#include "stats.h"
+#include "output_sink.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <queue>
+#include <thread>
+#include <atomic>
+using namespace std;
+
+TreeNodePool nodePool;
+
+// 与节点池中的树同步维护的二级索引（insert / deleteNode / bulkLoad 负责更新）
+NoveltyFreqIndex noveltyIndex;
+
+KeywordDictionary keywordDictionary;
+
+KeywordKey makeKeywordKey(string_view keyword, bool withRank) {
+    uint32_t id = keywordDictionary.find(keyword);
+    if (id != NO_KEYWORD_ID) return {keyword, id, true};
+    return {keyword, withRank ? keywordDictionary.lowerBound(keyword) : NO_KEYWORD_ID, false};
+}
+
+// 释放整棵树、索引及字典
+void clearTree() {
+    nodePool.clear();
+    noveltyIndex.clear();
+    keywordDictionary.clear();
+}
+
+TreeNode* root = nullptr;
+
+RowFormat outputFormat = RowFormat::TEXT;
+
+// 由孩子重新计算子树汇总值
+void updateAggregates(TreeNode* node) {
+    node->size = 1;
+    node->freqSum = node->freq;
+    node->noveltySum = node->freq * node->avg_novelty;
+    for (TreeNode* child : {node->left, node->right}) {
+        if (child != nullptr) {
+            node->size += child->size;
+            node->freqSum += child->freqSum;
+            node->noveltySum += child->noveltySum;
+        }
+    }
+}
+
+#ifdef USE_AVL_TREE
+// AVL平衡维护
+
+int nodeHeight(TreeNode* node) {
+    return node == nullptr ? 0 : node->height;
+}
+
+void updateHeight(TreeNode* node) {
+    node->height = 1 + max(nodeHeight(node->left), nodeHeight(node->right));
+}
+
+int balanceFactor(TreeNode* node) {
+    return nodeHeight(node->left) - nodeHeight(node->right);
+}
+
+TreeNode* rotateRight(TreeNode* node) {
+    TreeNode* newRoot = node->left;
+    node->left = newRoot->right;
+    newRoot->right = node;
+    updateHeight(node);
+    updateHeight(newRoot);
+    updateAggregates(node);
+    updateAggregates(newRoot);
+    return newRoot;
+}
+
+TreeNode* rotateLeft(TreeNode* node) {
+    TreeNode* newRoot = node->right;
+    node->right = newRoot->left;
+    newRoot->left = node;
+    updateHeight(node);
+    updateHeight(newRoot);
+    updateAggregates(node);
+    updateAggregates(newRoot);
+    return newRoot;
+}
+#endif
+
+// 子树发生变化后调用：更新汇总值；AVL模式下还更新高度并在失衡时旋转，普通模式下原样返回
+TreeNode* rebalance(TreeNode* node) {
+    updateAggregates(node);
+#ifdef USE_AVL_TREE
+    updateHeight(node);
+    int bf = balanceFactor(node);
+    if (bf > 1) {
+        if (balanceFactor(node->left) < 0) {   // LR型先把左子树左旋
+            node->left = rotateLeft(node->left);
+        }
+        return rotateRight(node);
+    }
+    if (bf < -1) {
+        if (balanceFactor(node->right) > 0) {  // RL型先把右子树右旋
+            node->right = rotateRight(node->right);
+        }
+        return rotateLeft(node);
+    }
+#endif
+    return node;
+}
+// 插入操作
+
+// 递归插入，返回新的子树根
+TreeNode* insertAt(TreeNode* node, const KeywordKey& key, int freq, double avg_novelty) {
+    if (node == nullptr) {   //出口，空就插入
+        TreeNode* created = nodePool.allocate(key.text, key.exact ? key.rank : NO_KEYWORD_ID, freq, avg_novelty);
+        noveltyIndex.insert(created->keyword, created->id, freq, avg_novelty);
+        return created;
+    }
+
+    STATS_COUNT("bst.insert.visits", 1);
+    int cmp = compareKey(key, node);
+    if (cmp < 0) {
+        node->left = insertAt(node->left, key, freq, avg_novelty);
+    } else if (cmp > 0) {
+        node->right = insertAt(node->right, key, freq, avg_novelty);
+    } else {
+        // 相等则更新
+        noveltyIndex.update(node->keyword, node->id, node->avg_novelty, freq, avg_novelty);
+        node->freq = freq;
+        node->avg_novelty = avg_novelty;
+    }
+
+    return rebalance(node);
+}
+
+TreeNode* insert(TreeNode* node, string keyword, int freq, double avg_novelty) {
+    STATS_COUNT("bst.insert.calls", 1);
+    return insertAt(node, makeKeywordKey(keyword), freq, avg_novelty);
+}
+
+// 查找操作
+
+TreeNode* searchKey(TreeNode* node, const KeywordKey& key) {
+    uint64_t visits = 0;
+    for (int cmp; node != nullptr && (cmp = compareKey(key, node)) != 0;) {
+        visits++;
+        node = cmp < 0 ? node->left : node->right;
+    }
+    STATS_COUNT("bst.search.calls", 1);
+    STATS_COUNT("bst.search.visits", visits + (node != nullptr));
+    return node;
+}
+
+TreeNode* search(TreeNode* node, string keyword) {
+    return searchKey(node, makeKeywordKey(keyword));
+}
+
+TreeNode* searchById(TreeNode* node, uint32_t id) {
+    if (id >= keywordDictionary.size()) return nullptr;
+    return searchKey(node, {keywordDictionary.keyword(id), id, true});
+}
+
+// 批量查找同时推进的查找路数
+const size_t BATCH_LANES = 16;
+
+void prefetchNode(const TreeNode* node) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(node);
+#endif
+}
+
+// 批量查找中的一路：依次查找keys[index, end)
+struct BatchLane {
+    size_t index, end;
+    TreeNode* node;
+    // 有序批量时记录查找路径：(节点, 该节点子树的上界节点)，子树中的关键词都小于上界，nullptr表示无上界
+    vector<pair<TreeNode*, TreeNode*>> path;
+};
+
+void searchBatch(TreeNode* root, const string_view* keys, size_t count, TreeNode** results) {
+    if (count == 0) return;
+
+    // 有序时每路负责一段连续的关键词：下一个关键词不小于上一个，所以它在路径上某个祖先的子树里，
+    // 回退到第一个上界大于它的节点继续下降即可，不必从根开始。无序时各路从共享的下标取下一个关键词
+    bool sorted = is_sorted(keys, keys + count);
+    vector<KeywordKey> keyOf(count);
+    for (size_t i = 0; i < count; i++) {
+        keyOf[i] = makeKeywordKey(keys[i]);
+    }
+    size_t laneCount = min(BATCH_LANES, count);
+    BatchLane lanes[BATCH_LANES];
+    size_t next = 0;
+    for (size_t i = 0; i < laneCount; i++) {
+        BatchLane& lane = lanes[i];
+        if (sorted) {
+            lane.index = count * i / laneCount;
+            lane.end = count * (i + 1) / laneCount;
+            lane.path.push_back({root, nullptr});
+        } else {
+            lane.index = next++;
+            lane.end = lane.index + 1;
+        }
+        lane.node = root;
+        prefetchNode(root);
+    }
+
+    size_t active = laneCount;
+    while (active > 0) {
+        for (size_t i = 0; i < laneCount; i++) {
+            BatchLane& lane = lanes[i];
+            if (lane.index == lane.end) continue;
+
+            TreeNode* node = lane.node;
+            int cmp = node == nullptr ? 0 : compareKey(keyOf[lane.index], node);
+            if (cmp != 0) {
+                TreeNode* child = cmp < 0 ? node->left : node->right;
+                if (sorted) lane.path.push_back({child, cmp < 0 ? node : lane.path.back().second});
+                prefetchNode(child);
+                lane.node = child;
+                continue;
+            }
+
+            // 当前关键词查找结束（找到或走到空子树），换下一个关键词
+            results[lane.index] = node;
+            if (sorted) {
+                if (++lane.index == lane.end) {
+                    active--;
+                    continue;
+                }
+                const KeywordKey& nextKey = keyOf[lane.index];
+                while (lane.path.back().second != nullptr && compareKey(nextKey, lane.path.back().second) >= 0) {
+                    lane.path.pop_back();
+                }
+                lane.node = lane.path.back().first;
+            } else {
+                if (next == count) {
+                    lane.index = lane.end;
+                    active--;
+                    continue;
+                }
+                lane.index = next++;
+                lane.end = lane.index + 1;
+                lane.node = root;
+            }
+        }
+    }
+}
+
+// 删除操作
+
+TreeNode* findMin(TreeNode* node) {
+    while (node->left != nullptr) {
+        node = node->left;
+    }
+    return node;
+}
+
+// 摘下并释放子树中的最小节点，返回新的子树根
+TreeNode* removeMin(TreeNode* node) {
+    if (node->left == nullptr) {
+        TreeNode* right = node->right;
+        nodePool.release(node);
+        return right;
+    }
+    node->left = removeMin(node->left);
+    return rebalance(node);
+}
+
+// 递归删除，返回新的子树根
+TreeNode* deleteAt(TreeNode* node, const KeywordKey& key) {
+    if (node == nullptr) {
+        return nullptr;
+    }
+
+    STATS_COUNT("bst.delete.visits", 1);
+    int cmp = compareKey(key, node);
+    if (cmp < 0) {
+        node->left = deleteAt(node->left, key);
+    } else if (cmp > 0) {
+        node->right = deleteAt(node->right, key);
+    } else {
+        // 找到要删除的节点
+        noveltyIndex.erase(node->keyword, node->id, node->avg_novelty);
+
+        // 情况1：叶子节点
+        if (node->left == nullptr && node->right == nullptr) {
+            nodePool.release(node);
+            return nullptr;
+        }
+        // 情况2：只有右子树
+        else if (node->left == nullptr) {
+            TreeNode* temp = node->right;//用右子树代填删除的结点
+            nodePool.release(node);
+            return temp;
+        }
+        // 情况3：只有左子树
+        else if (node->right == nullptr) {
+            TreeNode* temp = node->left;
+            nodePool.release(node);
+            return temp;
+        }
+        // 情况4：有两个子树（用中序后继替代）
+        else {
+            TreeNode* temp = findMin(node->right);
+            node->keyword = temp->keyword;
+            node->id = temp->id;
+            node->freq = temp->freq;
+            node->avg_novelty = temp->avg_novelty;
+            // 后继的索引项描述的仍是同一个关键词，只释放后继节点本身
+            node->right = removeMin(node->right);
+        }
+    }
+
+    return rebalance(node);
+}
+
+TreeNode* deleteNode(TreeNode* node, string keyword) {
+    STATS_COUNT("bst.delete.calls", 1);
+    return deleteAt(node, makeKeywordKey(keyword));
+}
+
+// 先序遍历（Pre-order）
+void preorderAt(TreeNode* node, BufferedSink& sink) {
+    if (node != nullptr) {
+        STATS_COUNT("bst.traversal.visits", 1);
+        sink.row(node->keyword, node->freq, node->avg_novelty);
+        preorderAt(node->left, sink);
+        preorderAt(node->right, sink);
+    }
+}
+
+void preorderTraversal(TreeNode* node) {
+    BufferedSink sink(cout, outputFormat);
+    preorderAt(node, sink);
+}
+
+// 中序遍历（In-order）
+void inorderAt(TreeNode* node, BufferedSink& sink) {
+    if (node != nullptr) {
+        inorderAt(node->left, sink);
+        STATS_COUNT("bst.traversal.visits", 1);
+        sink.row(node->keyword, node->freq, node->avg_novelty);
+        inorderAt(node->right, sink);
+    }
+}
+
+void inorderTraversal(TreeNode* node) {
+    BufferedSink sink(cout, outputFormat);
+    inorderAt(node, sink);
+}
+
+// 后序遍历（Post-order）
+void postorderAt(TreeNode* node, BufferedSink& sink) {
+    if (node != nullptr) {
+        postorderAt(node->left, sink);
+        postorderAt(node->right, sink);
+        STATS_COUNT("bst.traversal.visits", 1);
+        sink.row(node->keyword, node->freq, node->avg_novelty);
+    }
+}
+
+void postorderTraversal(TreeNode* node) {
+    BufferedSink sink(cout, outputFormat);
+    postorderAt(node, sink);
+}
+
+// 层次遍历（Level-order）
+void levelorderTraversal(TreeNode* root) {
+    if (root == nullptr) return;
+
+    BufferedSink sink(cout, outputFormat);
+    queue<TreeNode*> q;
+    q.push(root);
+
+    while (!q.empty()) {
+        TreeNode* current = q.front();
+        q.pop();
+        STATS_COUNT("bst.traversal.visits", 1);
+
+        sink.row(current->keyword, current->freq, current->avg_novelty);
+
+        if (current->left != nullptr) {
+            q.push(current->left);
+        }
+        if (current->right != nullptr) {
+            q.push(current->right);
+        }
+    }
+}
+
+// 并行中序导出的一段：一整棵子树，或两段之间的单个节点
+struct DumpPiece {
+    TreeNode* node;
+    bool wholeSubtree;
+};
+
+// 按中序把树切成互不相交的段：节点数不超过target的子树整段交给一个线程
+vector<DumpPiece> splitForDump(TreeNode* root, size_t target) {
+    vector<DumpPiece> pieces;
+    vector<TreeNode*> stack;
+    TreeNode* node = root;
+    while (node != nullptr || !stack.empty()) {
+        while (node != nullptr && node->size > target) {
+            stack.push_back(node);
+            node = node->left;
+        }
+        if (node != nullptr) {
+            pieces.push_back({node, true});
+        }
+        if (stack.empty()) break;
+        pieces.push_back({stack.back(), false});
+        node = stack.back()->right;
+        stack.pop_back();
+    }
+    return pieces;
+}
+
+// 把一段按中序格式化到buffer（显式栈，退化的子树也不会递归过深）
+void formatPiece(const DumpPiece& piece, RowFormat format, string& buffer) {
+    if (!piece.wholeSubtree) {
+        appendRow(buffer, format, piece.node->keyword, piece.node->freq, piece.node->avg_novelty);
+        return;
+    }
+    vector<TreeNode*> stack;
+    for (TreeNode* node = piece.node; node != nullptr || !stack.empty();) {
+        while (node != nullptr) {
+            stack.push_back(node);
+            node = node->left;
+        }
+        node = stack.back();
+        stack.pop_back();
+        appendRow(buffer, format, node->keyword, node->freq, node->avg_novelty);
+        node = node->right;
+    }
+}
+
+size_t dumpInOrder(TreeNode* root, ostream& out, RowFormat format, unsigned threadCount) {
+    STATS_TIMER("bst.dump");
+    if (threadCount == 0) threadCount = max(1u, thread::hardware_concurrency());
+    size_t n = root != nullptr ? root->size : 0;
+    // 段数约为线程数的16倍，让各线程的工作量大致均衡
+    vector<DumpPiece> pieces = splitForDump(root, max<size_t>(1024, n / (threadCount * 16)));
+
+    vector<string> buffers(pieces.size());
+    atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < pieces.size(); i = next++) {
+            formatPiece(pieces[i], format, buffers[i]);
+        }
+    };
+    vector<thread> workers;
+    for (unsigned i = 1; i < threadCount && i < pieces.size(); i++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (thread& t : workers) {
+        t.join();
+    }
+
+    string_view header = rowFormatHeader(format);
+    out.write(header.data(), header.size());
+    size_t written = header.size();
+    for (const string& buffer : buffers) {
+        out.write(buffer.data(), buffer.size());
+        written += buffer.size();
+    }
+    return written;
+}
+
+// 区间查询主函数：输出所有满足 L <= keyword <= R 的节点，边界不必是树中已有的关键词
+bool rangeQuery(TreeNode* root, string L, string R) {
+    // 检查左边界是否小于等于右边界
+    if (L > R) {
+        cout << "错误：左边界 \"" << L << "\" 大于右边界 \"" << R << "\"！" << endl;
+        return false;
+    }
+
+    BufferedSink sink(cout, outputFormat);
+    RangeCursor cursor(root, L, R);
+    uint64_t results = 0;
+    while (TreeNode* node = cursor.next()) {
+        sink.row(node->keyword, node->freq, node->avg_novelty);
+        results++;
+    }
+    STATS_COUNT("bst.range_query.calls", 1);
+    STATS_COUNT("bst.range_query.visits", cursor.nodesVisited());
+    STATS_COUNT("bst.range_query.results", results);
+    return true;
+}
+
+// 把节点本身及其一侧的整棵子树计入汇总
+void addToAggregate(RangeAggregate& result, TreeNode* node, TreeNode* wholeSubtree) {
+    result.count++;
+    result.freqSum += node->freq;
+    result.noveltySum += node->freq * node->avg_novelty;
+    if (wholeSubtree != nullptr) {
+        result.count += wholeSubtree->size;
+        result.freqSum += wholeSubtree->freqSum;
+        result.noveltySum += wholeSubtree->noveltySum;
+    }
+}
+
+RangeAggregate rangeAggregate(TreeNode* root, string_view L, string_view R) {
+    STATS_COUNT("bst.range_aggregate.calls", 1);
+    RangeAggregate result;
+    KeywordKey lower = makeKeywordKey(L, true);
+    KeywordKey upper = makeKeywordKey(R, true);
+    // 先找到第一个落在区间内的节点（两条边界路径的分叉点）
+    TreeNode* split = root;
+    while (split != nullptr && (compareKey(lower, split) > 0 || compareKey(upper, split) < 0)) {
+        split = compareKey(lower, split) > 0 ? split->right : split->left;
+    }
+    if (split == nullptr) return result;
+
+    addToAggregate(result, split, nullptr);
+    // 左边界路径：>= L 的节点连同它的右子树都在区间内
+    for (TreeNode* node = split->left; node != nullptr;) {
+        if (compareKey(lower, node) <= 0) {
+            addToAggregate(result, node, node->right);
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+    // 右边界路径：<= R 的节点连同它的左子树都在区间内
+    for (TreeNode* node = split->right; node != nullptr;) {
+        if (compareKey(upper, node) >= 0) {
+            addToAggregate(result, node, node->left);
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+    return result;
+}
+
+size_t rangeCount(TreeNode* root, string_view L, string_view R) {
+    return rangeAggregate(root, L, R).count;
+}
+
+size_t keywordRank(TreeNode* root, string_view keyword) {
+    KeywordKey key = makeKeywordKey(keyword, true);
+    size_t rank = 0;
+    for (TreeNode* node = root; node != nullptr;) {
+        if (compareKey(key, node) > 0) {
+            rank += 1 + (node->left != nullptr ? node->left->size : 0);
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+    return rank;
+}
+
+TreeNode* selectByRank(TreeNode* root, size_t k) {
+    TreeNode* node = root;
+    while (node != nullptr) {
+        size_t leftSize = node->left != nullptr ? node->left->size : 0;
+        if (k == leftSize) break;
+        if (k < leftSize) {
+            node = node->left;
+        } else {
+            k -= leftSize + 1;
+            node = node->right;
+        }
+    }
+    return node;
+}
+
+// 按新颖性和频率筛选关键词（中序递归），返回输出的个数
+uint64_t filterAt(TreeNode* node, double minNovelty, int minFreq, BufferedSink& sink) {
+    if (node == nullptr) return 0;
+
+    STATS_COUNT("bst.filter.visits", 1);
+    uint64_t matched = filterAt(node->left, minNovelty, minFreq, sink);
+
+    if (node->avg_novelty >= minNovelty && node->freq >= minFreq) {
+        sink.row(node->keyword, node->freq, node->avg_novelty);
+        matched++;
+    }
+
+    return matched + filterAt(node->right, minNovelty, minFreq, sink);
+}
+
+// 按新颖性和频率筛选关键词
+void filterByNoveltyAndFreq(TreeNode* node, double minNovelty, int minFreq) {
+    BufferedSink sink(cout, outputFormat);
+    uint64_t matched = filterAt(node, minNovelty, minFreq, sink);
+    STATS_COUNT("bst.filter.calls", 1);
+    STATS_COUNT("bst.filter.results", matched);
+}
+
+// 按新颖性和频率筛选关键词（走二级索引，只访问满足条件的条目附近的节点），按关键词字典序输出
+size_t filterByNoveltyAndFreqIndexed(double minNovelty, int minFreq) {
+    vector<NoveltyIndexEntry> matched;
+    noveltyIndex.query(minNovelty, minFreq, [&](const NoveltyIndexEntry& entry) {
+        matched.push_back(entry);
+    });
+    STATS_COUNT("bst.filter_indexed.calls", 1);
+    STATS_COUNT("bst.filter_indexed.results", matched.size());
+    sort(matched.begin(), matched.end(), [](const NoveltyIndexEntry& a, const NoveltyIndexEntry& b) {
+        return keywordLess(a.keyword, a.id, b.keyword, b.id);
+    });
+
+    BufferedSink sink(cout, outputFormat);
+    for (const NoveltyIndexEntry& entry : matched) {
+        sink.row(entry.keyword, entry.freq, entry.avg_novelty);
+    }
+    return matched.size();
+}
+void printIndexEntries(const vector<NoveltyIndexEntry>& entries) {
+    BufferedSink sink(cout, outputFormat);
+    for (const NoveltyIndexEntry& entry : entries) {
+        sink.row(entry.keyword, entry.freq, entry.avg_novelty);
+    }
+}
+
+size_t printTopByFreq(size_t k) {
+    vector<NoveltyIndexEntry> top = noveltyIndex.topByFreq(k);
+    STATS_COUNT("bst.top_by_freq.calls", 1);
+    printIndexEntries(top);
+    return top.size();
+}
+
+size_t printTopByNovelty(size_t k, int minFreq) {
+    vector<NoveltyIndexEntry> top = noveltyIndex.topByNovelty(k, minFreq);
+    STATS_COUNT("bst.top_by_novelty.calls", 1);
+    printIndexEntries(top);
+    return top.size();
+}
+
+// 读取关键词统计表（keyword,freq,avg_novelty）
+bool readKeywordCSV(const string& path, vector<KeywordRow>& rows) {
+    STATS_TIMER("bst.read_csv");
+    ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    string line;
+    bool isHeader = true;
+
+    while (getline(file, line)) {
+        if (isHeader) {
+            isHeader = false;
+            continue;
+        }
+
+        stringstream ss(line);
+        string keyword, freqStr, noveltyStr;
+
+        getline(ss, keyword, ',');
+        getline(ss, freqStr, ',');
+        getline(ss, noveltyStr, ',');
+
+        if (!keyword.empty()) {
+            rows.push_back({keyword, stoi(freqStr), stod(noveltyStr)});
+        }
+    }
+    file.close();
+    return true;
+}
+
+// 由有序、无重复的rows[lo, hi)递归建出高度最优的子树（取中点为根）
+TreeNode* buildBalanced(const vector<const KeywordRow*>& rows, size_t lo, size_t hi) {
+    if (lo >= hi) return nullptr;
+
+    size_t mid = lo + (hi - lo) / 2;
+    TreeNode* node = nodePool.allocate(rows[mid]->keyword, (uint32_t)mid, rows[mid]->freq, rows[mid]->avg_novelty);
+    noveltyIndex.insert(node->keyword, node->id, node->freq, node->avg_novelty);
+    node->left = buildBalanced(rows, lo, mid);
+    node->right = buildBalanced(rows, mid + 1, hi);
+    return rebalance(node);  // 左右子树高度差不超过1，这里只会更新节点信息，不会旋转
+}
+
+// 批量建树：分析程序输出的CSV已按关键词排好序，校验有序后O(n)直接建出平衡树；
+// 若输入无序则先稳定排序。重复的关键词与逐条insert的语义一致，保留最后一行
+TreeNode* bulkLoad(const vector<KeywordRow>& rows) {
+    STATS_TIMER("bst.bulk_load");
+    vector<const KeywordRow*> sorted;
+    sorted.reserve(rows.size());
+    for (const KeywordRow& row : rows) {
+        sorted.push_back(&row);
+    }
+
+    bool strictlyIncreasing = true;
+    for (size_t i = 1; i < rows.size() && strictlyIncreasing; i++) {
+        strictlyIncreasing = rows[i - 1].keyword < rows[i].keyword;
+    }
+
+    if (!strictlyIncreasing) {
+        stable_sort(sorted.begin(), sorted.end(), [](const KeywordRow* a, const KeywordRow* b) {
+            return a->keyword < b->keyword;
+        });
+        // 相同关键词只保留最后一行
+        size_t kept = 0;
+        for (size_t i = 0; i < sorted.size(); i++) {
+            if (kept > 0 && sorted[kept - 1]->keyword == sorted[i]->keyword) {
+                sorted[kept - 1] = sorted[i];
+            } else {
+                sorted[kept++] = sorted[i];
+            }
+        }
+        sorted.resize(kept);
+    }
+
+    // 排好序、去重后的下标就是关键词ID
+    keywordDictionary.clear();
+    for (const KeywordRow* row : sorted) {
+        keywordDictionary.append(row->keyword);
+    }
+    return buildBalanced(sorted, 0, sorted.size());
+}
+
+TreeNode* buildBalanced(const KeywordTableFile& table, size_t lo, size_t hi) {
+    if (lo >= hi) return nullptr;
+
+    size_t mid = lo + (hi - lo) / 2;
+    TreeNode* node = nodePool.allocate(table.keyword(mid), (uint32_t)mid, table.freq(mid), table.avgNovelty(mid));
+    noveltyIndex.insert(node->keyword, node->id, node->freq, node->avg_novelty);
+    node->left = buildBalanced(table, lo, mid);
+    node->right = buildBalanced(table, mid + 1, hi);
+    return rebalance(node);
+}
+
+TreeNode* bulkLoad(const KeywordTableFile& table) {
+    STATS_TIMER("bst.bulk_load");
+    keywordDictionary.clear();
+    for (size_t i = 0; i < table.size(); i++) {
+        keywordDictionary.append(table.keyword(i));
+    }
+    return buildBalanced(table, 0, table.size());
+}
+
+// 读取变化文件（action,keyword,freq,avg_novelty）
+bool readKeywordDelta(const string& path, vector<KeywordDelta>& deltas) {
+    ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    string line;
+    bool isHeader = true;
+
+    while (getline(file, line)) {
+        if (isHeader) {
+            isHeader = false;
+            continue;
+        }
+
+        stringstream ss(line);
+        string action, keyword, freqStr, noveltyStr;
+
+        getline(ss, action, ',');
+        getline(ss, keyword, ',');
+        getline(ss, freqStr, ',');
+        getline(ss, noveltyStr, ',');
+
+        if (!keyword.empty()) {
+            deltas.push_back({action, {keyword, stoi(freqStr), stod(noveltyStr)}});
+        }
+    }
+    file.close();
+    return true;
+}
+
+// insert遇到已有的关键词时就是更新，所以insert和update都走insert
+TreeNode* applyKeywordDelta(TreeNode* root, const vector<KeywordDelta>& deltas) {
+    STATS_TIMER("bst.apply_delta");
+    for (const KeywordDelta& delta : deltas) {
+        if (delta.action == "delete") {
+            root = deleteNode(root, delta.row.keyword);
+        } else {
+            root = insert(root, delta.row.keyword, delta.row.freq, delta.row.avg_novelty);
+        }
+    }
+    return root;
+}
+
+// 树高（按层统计，避免在退化树上递归过深）
+int treeHeight(TreeNode* root) {
+    if (root == nullptr) return 0;
+
+    int height = 0;
+    vector<TreeNode*> level = {root};
+    while (!level.empty()) {
+        height++;
+        vector<TreeNode*> next;
+        for (TreeNode* node : level) {
+            if (node->left != nullptr) next.push_back(node->left);
+            if (node->right != nullptr) next.push_back(node->right);
+        }
+        level.swap(next);
+    }
+    return height;
+}
+
+// 各深度上的节点数（根的深度为0）
+vector<uint64_t> depthHistogram(TreeNode* root) {
+    vector<uint64_t> counts;
+    vector<TreeNode*> level;
+    if (root != nullptr) level.push_back(root);
+    while (!level.empty()) {
+        counts.push_back(level.size());
+        vector<TreeNode*> next;
+        for (TreeNode* node : level) {
+            if (node->left != nullptr) next.push_back(node->left);
+            if (node->right != nullptr) next.push_back(node->right);
+        }
+        level.swap(next);
+    }
+    return counts;
+}
@@ -0,0 +1,730 @@
+#ifndef KEYWORD_BST_H
+#define KEYWORD_BST_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <new>
+#include <optional>
+#include <queue>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include "keyword_table_file.h"
+#include "output_sink.h"
+
+// 关键词BST：节点池、二级索引、区间游标、批量建树与只读快照。
+// 编译时加 -DUSE_AVL_TREE 切换为AVL自平衡模式（接口不变），默认为普通BST
+
+// 树节点结构（关键词字节存放在共享的字符串区中，节点本身只保存切片，另存关键词在字典中的ID）。
+// 每个节点还记录以它为根的子树的汇总值（节点数、freq之和、freq×avg_novelty之和），
+// 由rebalance和旋转维护，区间计数/汇总、排名与按名次选取都不必访问区间内的每个节点
+
+struct TreeNode {
+    std::string_view keyword;
+    uint32_t id;  // 关键词在keywordDictionary中的ID，字典外的关键词为NO_KEYWORD_ID
+    int freq;
+#ifdef USE_AVL_TREE
+    int height;  // 以该节点为根的子树高度（叶子为1）
+#endif
+    uint32_t size;        // 子树节点数
+    int64_t freqSum;      // 子树freq之和
+    double noveltySum;    // 子树 freq × avg_novelty 之和（全部出现次数的新颖度总和）
+    double avg_novelty;
+    TreeNode *left, *right;
+
+#ifdef USE_AVL_TREE
+    TreeNode(std::string_view k, uint32_t i, int f, double a)
+        : keyword(k), id(i), freq(f), height(1), size(1), freqSum(f), noveltySum(f * a), avg_novelty(a), left(nullptr), right(nullptr) {}
+#else
+    TreeNode(std::string_view k, uint32_t i, int f, double a)
+        : keyword(k), id(i), freq(f), size(1), freqSum(f), noveltySum(f * a), avg_novelty(a), left(nullptr), right(nullptr) {}
+#endif
+};
+
+// 关键词查找键：文本及其在字典中的位置。与带ID的节点比较时只比较整数、不访问关键词字节，
+// 只有字典外的节点（建树之后新插入的关键词）才比较字符串。由makeKeywordKey生成
+struct KeywordKey {
+    std::string_view text;
+    uint32_t rank;  // 字典中小于text的关键词个数，NO_KEYWORD_ID表示没有算（只比较字符串）
+    bool exact;     // text在字典中（rank即为它的ID）
+};
+
+// key与节点的关键词按字典序比较：小于返回负数，相等返回0，大于返回正数
+inline int compareKey(const KeywordKey& key, const TreeNode* node) {
+    if (node->id != NO_KEYWORD_ID && key.rank != NO_KEYWORD_ID) {
+        if (node->id < key.rank) return 1;
+        return node->id == key.rank && key.exact ? 0 : -1;
+    }
+    return key.text.compare(node->keyword);
+}
+
+// 两个关键词按字典序比较：都在字典中时只比较ID
+inline bool keywordLess(std::string_view a, uint32_t aId, std::string_view b, uint32_t bId) {
+    return aId != NO_KEYWORD_ID && bId != NO_KEYWORD_ID ? aId < bId : a < b;
+}
+
+inline bool keywordEqual(std::string_view a, uint32_t aId, std::string_view b, uint32_t bId) {
+    return aId != NO_KEYWORD_ID && bId != NO_KEYWORD_ID ? aId == bId : a == b;
+}
+
+// 字符串区：按块追加关键词字节，块不会搬移，所以切片一直有效；只能整体释放
+class StringArena {
+public:
+    std::string_view store(std::string_view str) {
+        if (blocks.empty() || used + str.length() > blockCapacity) {
+            blockCapacity = std::max(BLOCK_SIZE, str.length());
+            blocks.emplace_back(new char[blockCapacity]);
+            reservedBytes += blockCapacity;
+            used = 0;
+        }
+        char* dest = blocks.back().get() + used;
+        std::copy(str.begin(), str.end(), dest);
+        used += str.length();
+        totalBytes += str.length();
+        return std::string_view(dest, str.length());
+    }
+
+    void clear() {
+        blocks.clear();
+        used = blockCapacity = totalBytes = reservedBytes = 0;
+    }
+
+    size_t bytesUsed() const { return totalBytes; }
+    // 超过BLOCK_SIZE的关键词单独占一块，块大小不一，所以按实际申请的字节累计
+    size_t bytesReserved() const { return reservedBytes; }
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t used = 0;
+    size_t blockCapacity = 0;
+    size_t totalBytes = 0;
+    size_t reservedBytes = 0;
+};
+
+// 节点池：按块批量申请TreeNode，删除的节点挂到空闲链表上复用，整棵树一次性释放
+class TreeNodePool {
+public:
+    ~TreeNodePool() { clear(); }
+
+    TreeNode* allocate(std::string_view keyword, uint32_t id, int freq, double avg_novelty) {
+        void* memory;
+        if (freeList != nullptr) {
+            memory = freeList;
+            freeList = freeList->right;
+        } else {
+            if (blocks.empty() || used == BLOCK_NODES) {
+                blocks.push_back(static_cast<TreeNode*>(::operator new(sizeof(TreeNode) * BLOCK_NODES)));
+                used = 0;
+            }
+            memory = blocks.back() + used++;
+        }
+        liveNodes++;
+        return new (memory) TreeNode(keywords.store(keyword), id, freq, avg_novelty);
+    }
+
+    // 单个节点只回收到空闲链表，关键词字节留在字符串区直到整体释放
+    void release(TreeNode* node) {
+        node->right = freeList;
+        freeList = node;
+        liveNodes--;
+    }
+
+    // 释放池中所有节点和关键词（TreeNode可平凡析构，无需逐个析构）
+    void clear() {
+        for (TreeNode* block : blocks) {
+            ::operator delete(block);
+        }
+        blocks.clear();
+        keywords.clear();
+        freeList = nullptr;
+        used = liveNodes = 0;
+    }
+
+    size_t nodeCount() const { return liveNodes; }
+    size_t nodeBytesReserved() const { return blocks.size() * BLOCK_NODES * sizeof(TreeNode); }
+    const StringArena& keywordArena() const { return keywords; }
+
+private:
+    static constexpr size_t BLOCK_NODES = 4096;
+    std::vector<TreeNode*> blocks;
+    TreeNode* freeList = nullptr;
+    size_t used = 0;
+    size_t liveNodes = 0;
+    StringArena keywords;
+};
+
+extern TreeNodePool nodePool;
+
+// 二级索引：按 (avg_novelty, freq) 回答 "avg_novelty >= x 且 freq >= y" 的筛选，以及按频率或新颖度取前K个。
+// 结构是按 (avg_novelty, keyword) 有序的treap：优先级是随机数，与freq、新颖度的分布无关，树高期望为O(log n)；
+// 每个节点另记子树中的最大freq，子树的maxFreq低于阈值时整棵剪掉。插入、删除、查询都用显式栈，不递归。
+// 筛选访问的节点都在某个结果的祖先路径上，代价期望为O((k + 1) log n)。节点放在数组里，用32位下标链接
+struct NoveltyIndexEntry {
+    std::string_view keyword;
+    uint32_t id;
+    int freq;
+    double avg_novelty;
+};
+
+class NoveltyFreqIndex {
+public:
+    void insert(std::string_view keyword, uint32_t id, int freq, double avg_novelty) {
+        uint32_t node = newNode({keyword, id, freq, avg_novelty});
+        const NoveltyIndexEntry& entry = nodes[node].entry;
+
+        // 按搜索树键下降到空位挂上新节点，沿途的maxFreq先计入新节点
+        path.clear();
+        uint32_t t = root;
+        while (t != NIL) {
+            path.push_back(t);
+            nodes[t].maxFreq = std::max(nodes[t].maxFreq, freq);
+            t = keyLess(entry.avg_novelty, entry.keyword, entry.id, nodes[t].entry) ? nodes[t].left : nodes[t].right;
+        }
+        if (path.empty()) {
+            root = node;
+            return;
+        }
+        uint32_t parent = path.back();
+        (keyLess(entry.avg_novelty, entry.keyword, entry.id, nodes[parent].entry) ? nodes[parent].left : nodes[parent].right) = node;
+
+        // 优先级高于父节点时向上旋转
+        while (!path.empty() && nodes[node].priority > nodes[path.back()].priority) {
+            parent = path.back();
+            path.pop_back();
+            uint32_t top = nodes[parent].left == node ? rotateRight(parent) : rotateLeft(parent);
+            replaceChild(parent, top);
+        }
+    }
+
+    void erase(std::string_view keyword, uint32_t id, double avg_novelty) {
+        path.clear();
+        uint32_t t = root;
+        while (t != NIL && !(nodes[t].entry.avg_novelty == avg_novelty && keywordEqual(nodes[t].entry.keyword, nodes[t].entry.id, keyword, id))) {
+            path.push_back(t);
+            t = keyLess(avg_novelty, keyword, id, nodes[t].entry) ? nodes[t].left : nodes[t].right;
+        }
+        if (t == NIL) return;
+
+        // 把优先级较高的孩子转上来，待删节点下沉到最多只有一个孩子时摘掉
+        while (nodes[t].left != NIL && nodes[t].right != NIL) {
+            uint32_t top = nodes[nodes[t].left].priority > nodes[nodes[t].right].priority ? rotateRight(t) : rotateLeft(t);
+            replaceChild(t, top);
+            path.push_back(top);
+        }
+        replaceChild(t, nodes[t].left != NIL ? nodes[t].left : nodes[t].right);
+        freeSlots.push_back(t);
+
+        // 自下而上重算路径上的maxFreq
+        for (size_t i = path.size(); i-- > 0;) {
+            pull(path[i]);
+        }
+    }
+
+    void update(std::string_view keyword, uint32_t id, double oldNovelty, int freq, double avg_novelty) {
+        erase(keyword, id, oldNovelty);
+        insert(keyword, id, freq, avg_novelty);
+    }
+
+    void clear() {
+        nodes.clear();
+        freeSlots.clear();
+        root = NIL;
+        seed = 2463534242u;
+    }
+
+    size_t size() const { return nodes.size() - freeSlots.size(); }
+
+    // 对每个满足 avg_novelty >= minNovelty 且 freq >= minFreq 的条目调用visit（不保证顺序），返回条目数
+    template <class Visit>
+    size_t query(double minNovelty, int minFreq, Visit visit) const {
+        size_t count = 0;
+        std::vector<uint32_t> stack;
+        if (root != NIL) stack.push_back(root);
+        while (!stack.empty()) {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+            if (node.maxFreq < minFreq) continue;  // 整棵子树的freq都不够
+            if (node.entry.avg_novelty >= minNovelty) {
+                if (node.entry.freq >= minFreq) {
+                    visit(node.entry);
+                    count++;
+                }
+                if (node.left != NIL) stack.push_back(node.left);
+            }
+            if (node.right != NIL) stack.push_back(node.right);
+        }
+        return count;
+    }
+
+    // freq最高的k个条目，freq降序、同频按关键词字典序。
+    // 按子树maxFreq最佳优先展开：队列里是 子树（键为maxFreq）和 单个节点（键为freq），
+    // 弹出的节点freq不增，第k个条目所在的同频条目会全部取出后再按关键词排序截断。
+    // 展开的子树都含有不低于第k大freq的条目，不计同频时代价期望为O(k log n · log k)
+    std::vector<NoveltyIndexEntry> topByFreq(size_t k) const {
+        std::vector<NoveltyIndexEntry> result;
+        if (k == 0 || root == NIL) return result;
+
+        struct Candidate {
+            int key;
+            uint32_t node;
+            bool subtree;
+            bool operator<(const Candidate& other) const { return key < other.key; }
+        };
+        std::priority_queue<Candidate> frontier;
+        frontier.push({nodes[root].maxFreq, root, true});
+        while (!frontier.empty()) {
+            Candidate top = frontier.top();
+            if (result.size() >= k && top.key < result[k - 1].freq) break;
+            frontier.pop();
+            const Node& node = nodes[top.node];
+            if (!top.subtree) {
+                result.push_back(node.entry);
+                continue;
+            }
+            frontier.push({node.entry.freq, top.node, false});
+            if (node.left != NIL) frontier.push({nodes[node.left].maxFreq, node.left, true});
+            if (node.right != NIL) frontier.push({nodes[node.right].maxFreq, node.right, true});
+        }
+        std::sort(result.begin(), result.end(), [](const NoveltyIndexEntry& a, const NoveltyIndexEntry& b) {
+            return a.freq != b.freq ? a.freq > b.freq : keywordLess(a.keyword, a.id, b.keyword, b.id);
+        });
+        if (result.size() > k) result.resize(k);
+        return result;
+    }
+
+    // freq >= minFreq 的条目中 avg_novelty 最高的k个，按 (avg_novelty, keyword) 降序。
+    // 用显式栈按搜索树键从大到小中序遍历，maxFreq低于阈值的子树整棵剪掉，取满k个即停。
+    // 访问的节点都在前k+1个满足条件的条目的祖先路径上，代价期望为O((k + 1) log n)
+    std::vector<NoveltyIndexEntry> topByNovelty(size_t k, int minFreq) const {
+        std::vector<NoveltyIndexEntry> result;
+        std::vector<uint32_t> stack;
+        uint32_t t = root;
+        while (result.size() < k) {
+            while (t != NIL && nodes[t].maxFreq >= minFreq) {
+                stack.push_back(t);
+                t = nodes[t].right;
+            }
+            if (stack.empty()) break;
+            t = stack.back();
+            stack.pop_back();
+            if (nodes[t].entry.freq >= minFreq) result.push_back(nodes[t].entry);
+            t = nodes[t].left;
+        }
+        return result;
+    }
+
+private:
+    static const uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Node {
+        NoveltyIndexEntry entry;
+        uint32_t priority;  // 随机优先级，大的在上
+        int maxFreq;        // 子树中最大的freq
+        uint32_t left, right;
+    };
+
+    uint32_t newNode(const NoveltyIndexEntry& entry) {
+        // xorshift32：只需要与键无关，固定种子使树形可重现
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        Node node = {entry, seed, entry.freq, NIL, NIL};
+        if (!freeSlots.empty()) {
+            uint32_t index = freeSlots.back();
+            freeSlots.pop_back();
+            nodes[index] = node;
+            return index;
+        }
+        nodes.push_back(node);
+        return (uint32_t)nodes.size() - 1;
+    }
+
+    // 搜索树的键：(avg_novelty, keyword)
+    bool keyLess(double novelty, std::string_view keyword, uint32_t id, const NoveltyIndexEntry& entry) const {
+        return novelty < entry.avg_novelty || (novelty == entry.avg_novelty && keywordLess(keyword, id, entry.keyword, entry.id));
+    }
+
+    // 由孩子重算maxFreq
+    void pull(uint32_t t) {
+        Node& node = nodes[t];
+        node.maxFreq = node.entry.freq;
+        if (node.left != NIL) node.maxFreq = std::max(node.maxFreq, nodes[node.left].maxFreq);
+        if (node.right != NIL) node.maxFreq = std::max(node.maxFreq, nodes[node.right].maxFreq);
+    }
+
+    uint32_t rotateRight(uint32_t t) {
+        uint32_t l = nodes[t].left;
+        nodes[t].left = nodes[l].right;
+        nodes[l].right = t;
+        pull(t);
+        pull(l);
+        return l;
+    }
+
+    uint32_t rotateLeft(uint32_t t) {
+        uint32_t r = nodes[t].right;
+        nodes[t].right = nodes[r].left;
+        nodes[r].left = t;
+        pull(t);
+        pull(r);
+        return r;
+    }
+
+    // path.back()（为空时是根）原来指向old的链接改为指向node
+    void replaceChild(uint32_t old, uint32_t node) {
+        if (path.empty()) {
+            root = node;
+        } else if (nodes[path.back()].left == old) {
+            nodes[path.back()].left = node;
+        } else {
+            nodes[path.back()].right = node;
+        }
+    }
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> freeSlots;
+    std::vector<uint32_t> path;  // 插入、删除时从根下来的路径
+    uint32_t root = NIL;
+    uint32_t seed = 2463534242u;
+};
+
+// 与节点池中的树同步维护的二级索引（insert / deleteNode / bulkLoad 负责更新）
+extern NoveltyFreqIndex noveltyIndex;
+
+// 当前的树根
+extern TreeNode* root;
+
+// 树中关键词的保序字典：bulkLoad按建树的关键词（即分析程序输出的统计表）重建，clearTree时清空。
+// 建树之后插入的字典外关键词没有ID，与其他节点比较时退回字符串比较，顺序仍然正确
+extern KeywordDictionary keywordDictionary;
+
+// 查找、插入、删除、区间等函数先用它把关键词换成查找键（一次哈希查找），之后沿树下降只比较整数。
+// 字典外的关键词：withRank为true时（区间边界、排名）再在字典中二分得到它的位置，否则沿树下降时比较字符串。
+// 不先查一次无法知道关键词在不在字典里，所以未命中的查找比纯字符串比较多一次哈希和一次探测（约一次缓存未命中）；
+// 只用二分代替哈希要做约log2(n)次字符串比较，命中和未命中都更慢
+KeywordKey makeKeywordKey(std::string_view keyword, bool withRank = false);
+
+// 释放整棵树、索引及字典
+void clearTree();
+
+// 子树发生变化后调用：更新汇总值；AVL模式下还更新高度并在失衡时旋转，普通模式下原样返回
+TreeNode* rebalance(TreeNode* node);
+
+// 插入（关键词已存在时更新频率与新颖度）、查找、删除
+TreeNode* insert(TreeNode* node, std::string keyword, int freq, double avg_novelty);
+TreeNode* search(TreeNode* node, std::string keyword);
+// 按字典ID查找（如哈夫曼解码得到的关键词ID），全程只比较整数
+TreeNode* searchById(TreeNode* node, uint32_t id);
+
+// 批量查找：results[i] = search(root, keys[i])。一组查找同时推进、逐层交错下降，
+// 每走一步都预取下一个节点，让多个查找的缓存未命中重叠；keys有序时每路沿用上一个关键词的查找路径
+void searchBatch(TreeNode* root, const std::string_view* keys, size_t count, TreeNode** results);
+TreeNode* findMin(TreeNode* node);
+TreeNode* removeMin(TreeNode* node);
+TreeNode* deleteNode(TreeNode* node, std::string keyword);
+
+// 遍历、区间查询、筛选、取前K个等输出结果的函数所用的行格式（默认为TEXT），输出经过缓冲区写到cout
+extern RowFormat outputFormat;
+
+// 先序、中序、后序、层次遍历，逐行输出节点
+void preorderTraversal(TreeNode* node);
+void inorderTraversal(TreeNode* node);
+void postorderTraversal(TreeNode* node);
+void levelorderTraversal(TreeNode* root);
+
+// 按中序把整棵树导出到out：按子树切成互不相交的段，多个线程各自格式化到自己的缓冲区，再按顺序拼接写出。
+// 输出与单线程中序遍历逐字节相同；threadCount为0时取CPU核数。返回写出的字节数
+size_t dumpInOrder(TreeNode* root, std::ostream& out, RowFormat format, unsigned threadCount = 0);
+
+// 区间游标：按字典序依次给出满足 lower <= keyword <= upper 的节点，边界为nullopt时表示该端不设限。
+// 只沿边界路径下降并剪掉区间外的子树，总代价O(h + k)；显式栈不递归，树高不超过64时不申请堆内存
+class RangeCursor {
+public:
+    RangeCursor(TreeNode* root, std::optional<std::string_view> lower, std::optional<std::string_view> upper) {
+        if (upper) this->upper = makeKeywordKey(*upper, true);
+        std::optional<KeywordKey> lowerKey;
+        if (lower) lowerKey = makeKeywordKey(*lower, true);
+
+        // 从根走到第一个 >= lower 的节点，沿途把可能在区间内的祖先压栈
+        TreeNode* node = root;
+        while (node != nullptr) {
+            visited++;
+            if (lowerKey && compareKey(*lowerKey, node) > 0) {
+                node = node->right;  // 当前节点及其左子树都小于lower
+            } else {
+                push(node);
+                node = node->left;
+            }
+        }
+    }
+
+    RangeCursor(const RangeCursor&) = delete;
+    RangeCursor& operator=(const RangeCursor&) = delete;
+
+    // 返回下一个区间内的节点，遍历结束返回nullptr
+    TreeNode* next() {
+        if (depth == 0) return nullptr;
+
+        TreeNode* node = pop();
+        if (upper && compareKey(*upper, node) < 0) {
+            depth = 0;  // 之后的节点都更大
+            overflow.clear();
+            return nullptr;
+        }
+        for (TreeNode* child = node->right; child != nullptr; child = child->left) {
+            push(child);
+            visited++;
+        }
+        return node;
+    }
+
+    // 到目前为止访问过的节点数（下降路径加上压栈的节点）
+    size_t nodesVisited() const { return visited; }
+
+private:
+    static const size_t INLINE_DEPTH = 64;
+
+    void push(TreeNode* node) {
+        if (depth < INLINE_DEPTH) {
+            inlineStack[depth] = node;
+        } else {
+            overflow.push_back(node);  // 只有退化的普通BST才会用到
+        }
+        depth++;
+    }
+
+    TreeNode* pop() {
+        depth--;
+        if (depth < INLINE_DEPTH) return inlineStack[depth];
+        TreeNode* node = overflow.back();
+        overflow.pop_back();
+        return node;
+    }
+
+    std::optional<KeywordKey> upper;
+    TreeNode* inlineStack[INLINE_DEPTH];
+    std::vector<TreeNode*> overflow;
+    size_t depth = 0;
+    size_t visited = 0;
+};
+
+// 区间扫描：对区间内的每个节点按字典序调用visit，返回节点个数
+template <class Visit>
+size_t rangeScan(TreeNode* root, std::optional<std::string_view> lower, std::optional<std::string_view> upper, Visit visit) {
+    RangeCursor cursor(root, lower, upper);
+    size_t count = 0;
+    while (TreeNode* node = cursor.next()) {
+        visit(node);
+        count++;
+    }
+    return count;
+}
+
+// 区间查询：输出所有满足 L <= keyword <= R 的节点，L > R 时返回false
+bool rangeQuery(TreeNode* root, std::string L, std::string R);
+
+// 区间汇总：满足 L <= keyword <= R 的关键词个数、freq之和、freq×avg_novelty之和
+struct RangeAggregate {
+    size_t count = 0;
+    int64_t freqSum = 0;
+    double noveltySum = 0;
+
+    // 按出现次数加权的平均新颖度
+    double weightedNovelty() const { return freqSum > 0 ? noveltySum / freqSum : 0; }
+};
+
+// 以下都只沿边界路径下降，O(h)，不访问区间内的节点
+RangeAggregate rangeAggregate(TreeNode* root, std::string_view L, std::string_view R);
+size_t rangeCount(TreeNode* root, std::string_view L, std::string_view R);
+// 树中小于keyword的关键词个数（keyword在树中时即它的0起名次）
+size_t keywordRank(TreeNode* root, std::string_view keyword);
+// 字典序第k个（从0起）关键词所在的节点，k超出范围时返回nullptr
+TreeNode* selectByRank(TreeNode* root, size_t k);
+
+// 按新颖性和频率筛选关键词：全表中序扫描 / 走二级索引（按关键词字典序输出，返回条目数）
+void filterByNoveltyAndFreq(TreeNode* node, double minNovelty, int minFreq);
+size_t filterByNoveltyAndFreqIndexed(double minNovelty, int minFreq);
+// 频率最高的k个关键词，以及 freq >= minFreq 中新颖度最高的k个（走二级索引，不扫描全树），逐行输出，返回输出的个数
+size_t printTopByFreq(size_t k);
+size_t printTopByNovelty(size_t k, int minFreq);
+
+// 关键词统计表中的一行
+struct KeywordRow {
+    std::string keyword;
+    int freq;
+    double avg_novelty;
+};
+
+// 读取关键词统计表（keyword,freq,avg_novelty）
+bool readKeywordCSV(const std::string& path, std::vector<KeywordRow>& rows);
+
+// 批量建树：有序输入O(n)直接建出平衡树，无序时先稳定排序；重复的关键词保留最后一行。
+// 同时按排好序的关键词重建keywordDictionary，第i个关键词的ID为i（须先clearTree）
+TreeNode* bulkLoad(const std::vector<KeywordRow>& rows);
+
+// 由二进制统计表批量建树（KeywordTableFile::open已检查关键词严格递增，直接从映射的各列建树，不解析文本），表中第i项的ID为i
+TreeNode* bulkLoad(const KeywordTableFile& table);
+
+// 分析程序增量模式输出的一条变化（action为insert/update/delete）
+struct KeywordDelta {
+    std::string action;
+    KeywordRow row;
+};
+
+// 读取变化文件（action,keyword,freq,avg_novelty）
+bool readKeywordDelta(const std::string& path, std::vector<KeywordDelta>& deltas);
+
+// 用insert/deleteNode把变化应用到树上，返回新的树根
+TreeNode* applyKeywordDelta(TreeNode* root, const std::vector<KeywordDelta>& deltas);
+
+// 只读快照：把建好的BST冻结成Eytzinger布局（按层序存放的隐式完全二叉树，第k个槽的孩子在2k和2k+1）。
+// 关键词按字典序紧凑存放在一块字符串区中，每个槽内联关键词的前8个字节（大端序），
+// 查找时绝大多数比较只是一次整数比较；下降时预取8个槽之后（3层以下）所在的缓存行
+struct SnapshotEntry {
+    std::string_view keyword;
+    int freq;
+    double avg_novelty;
+};
+
+class KeywordSnapshot {
+public:
+    explicit KeywordSnapshot(TreeNode* root) {
+        // 非递归中序遍历，得到按关键词排好序的各列
+        std::vector<TreeNode*> stack;
+        size_t keywordBytes = 0;
+        std::vector<TreeNode*> sorted;
+        for (TreeNode* node = root; node != nullptr || !stack.empty();) {
+            while (node != nullptr) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            sorted.push_back(node);
+            keywordBytes += node->keyword.length();
+            node = node->right;
+        }
+
+        count = sorted.size();
+        keywordArena.reserve(keywordBytes);
+        offsets.reserve(count + 1);
+        freqs.reserve(count);
+        novelties.reserve(count);
+        for (TreeNode* node : sorted) {
+            offsets.push_back((uint32_t)keywordArena.size());
+            keywordArena.append(node->keyword.data(), node->keyword.length());
+            freqs.push_back(node->freq);
+            novelties.push_back(node->avg_novelty);
+        }
+        offsets.push_back((uint32_t)keywordArena.size());
+
+        // 槽0不用；按中序把排好序的下标填进隐式树
+        prefixes.assign(count + 1, 0);
+        slotIndex.assign(count + 1, 0);
+        size_t next = 0;
+        fillSlots(1, next);
+    }
+
+    size_t size() const { return count; }
+
+    SnapshotEntry at(size_t index) const {
+        return {keywordAt(index), freqs[index], novelties[index]};
+    }
+
+    // 第一个 >= keyword 的位置（按字典序的下标），不存在时返回size()
+    size_t lowerBound(std::string_view keyword) const {
+        uint64_t prefix = keyPrefix(keyword);
+        size_t k = 1;
+        while (k <= count) {
+            prefetch(k * 8);
+            k = 2 * k + (compareSlot(k, keyword, prefix) < 0 ? 1 : 0);
+        }
+        // 去掉最后连续向右走的几步，剩下的就是最后一次向左走的槽
+        while (k & 1) k >>= 1;
+        k >>= 1;
+        return k == 0 ? count : slotIndex[k];
+    }
+
+    // 第一个 > keyword 的位置
+    size_t upperBound(std::string_view keyword) const {
+        size_t index = lowerBound(keyword);
+        if (index < count && keywordAt(index) == keyword) index++;
+        return index;
+    }
+
+    const SnapshotEntry* search(std::string_view keyword, SnapshotEntry& result) const {
+        size_t index = lowerBound(keyword);
+        if (index == count || keywordAt(index) != keyword) return nullptr;
+        result = at(index);
+        return &result;
+    }
+
+    // 中序（字典序）遍历全部关键词
+    template <class Visit>
+    void forEach(Visit visit) const {
+        for (size_t i = 0; i < count; i++) visit(at(i));
+    }
+
+    // 区间遍历：L <= keyword <= R
+    template <class Visit>
+    void forEachInRange(std::string_view L, std::string_view R, Visit visit) const {
+        for (size_t i = lowerBound(L), end = upperBound(R); i < end; i++) visit(at(i));
+    }
+
+private:
+    std::string_view keywordAt(size_t index) const {
+        return std::string_view(keywordArena.data() + offsets[index], offsets[index + 1] - offsets[index]);
+    }
+
+    // 关键词前8个字节按大端序拼成整数，不足8字节补0，整数大小关系与字典序一致
+    static uint64_t keyPrefix(std::string_view keyword) {
+        uint64_t prefix = 0;
+        for (size_t i = 0; i < 8; i++) {
+            prefix = (prefix << 8) | (i < keyword.length() ? (unsigned char)keyword[i] : 0);
+        }
+        return prefix;
+    }
+
+    // 槽k的关键词与keyword比较：先比内联前缀，相同时再比剩余字节
+    int compareSlot(size_t k, std::string_view keyword, uint64_t prefix) const {
+        if (prefixes[k] != prefix) return prefixes[k] < prefix ? -1 : 1;
+        std::string_view slotKeyword = keywordAt(slotIndex[k]);
+        if (slotKeyword.length() <= 8 && keyword.length() <= 8) {
+            return slotKeyword.length() < keyword.length() ? -1 : (slotKeyword.length() > keyword.length() ? 1 : 0);
+        }
+        return slotKeyword.compare(keyword);
+    }
+
+    void prefetch(size_t k) const {
+#if defined(__GNUC__) || defined(__clang__)
+        if (k < prefixes.size()) __builtin_prefetch(&prefixes[k]);
+#endif
+    }
+
+    void fillSlots(size_t k, size_t& next) {
+        if (k > count) return;
+        fillSlots(2 * k, next);
+        slotIndex[k] = (uint32_t)next;
+        prefixes[k] = keyPrefix(keywordAt(next));
+        next++;
+        fillSlots(2 * k + 1, next);
+    }
+
+    size_t count = 0;
+    std::vector<uint64_t> prefixes;   // Eytzinger槽：关键词前缀
+    std::vector<uint32_t> slotIndex;  // Eytzinger槽：对应的字典序下标
+    std::string keywordArena;         // 按字典序紧凑存放的关键词
+    std::vector<uint32_t> offsets;
+    std::vector<int> freqs;
+    std::vector<double> novelties;
+};
+
+// 树高（按层统计，避免在退化树上递归过深）
+int treeHeight(TreeNode* root);
+// 各深度上的节点数（根的深度为0），用于 --stats 输出
+std::vector<uint64_t> depthHistogram(TreeNode* root);
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef KEYWORD_HASH_H
+#define KEYWORD_HASH_H
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 关键词哈希：FNV-1a，以及统计表和关键词字典共用的开放寻址索引
+
+const uint32_t FNV1A32_OFFSET_BASIS = 2166136261u;
+const uint64_t FNV1A64_OFFSET_BASIS = 14695981039346656037ull;
+
+// 32位FNV-1a，用于哈希表
+inline uint32_t fnv1a32(std::string_view bytes) {
+    uint32_t hash = FNV1A32_OFFSET_BASIS;
+    for (char c : bytes) {
+        hash = (hash ^ (unsigned char)c) * 16777619u;
+    }
+    return hash;
+}
+
+// 64位FNV-1a，用于文件校验；传入上一段的结果可以接着哈希下一段
+inline uint64_t fnv1a64(std::string_view bytes, uint64_t hash = FNV1A64_OFFSET_BASIS) {
+    for (char c : bytes) {
+        hash = (hash ^ (unsigned char)c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// 关键词 -> 编号 的开放寻址（线性探测）索引。槽位只存哈希值和编号+1，关键词本身由使用者保存，
+// 探测时先比哈希，相同再通过keywordAt(编号)取回关键词比较字符串。装载率超过0.75时扩容
+class KeywordHashIndex {
+public:
+    KeywordHashIndex() : slots(INITIAL_SLOTS) {}
+
+    // 找关键词所在的槽；不存在时返回探测到的空槽，可以直接交给fill插入
+    template <class KeywordAt>
+    size_t probe(std::string_view keyword, uint32_t hash, KeywordAt keywordAt) const {
+        size_t mask = slots.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots[i];
+            if (slot.entry == 0 || (slot.hash == hash && keywordAt(slot.entry - 1) == keyword)) {
+                return i;
+            }
+        }
+    }
+
+    bool occupied(size_t slot) const { return slots[slot].entry != 0; }
+    uint32_t id(size_t slot) const { return slots[slot].entry - 1; }
+
+    // 把编号id放进probe返回的空槽；count是放入后的条目总数
+    void fill(size_t slot, uint32_t hash, uint32_t id, size_t count) {
+        slots[slot].hash = hash;
+        slots[slot].entry = id + 1;
+        if (count * 4 > slots.size() * 3) {
+            grow();
+        }
+    }
+
+    void clear() { slots.assign(INITIAL_SLOTS, Slot()); }
+
+    size_t memoryBytes() const { return slots.capacity() * sizeof(Slot); }
+
+private:
+    static const size_t INITIAL_SLOTS = 1024;
+
+    struct Slot {
+        uint32_t hash = 0;
+        uint32_t entry = 0;  // 编号+1，0表示空槽
+    };
+
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        size_t mask = slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.entry == 0) continue;
+            size_t i = slot.hash & mask;
+            while (slots[i].entry != 0) i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+    }
+
+    std::vector<Slot> slots;
+};
+
+#endif
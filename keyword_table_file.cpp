@@ -0,0 +1,178 @@
+#include "keyword_table_file.h"
+#include <fstream>
+#include <cstring>
+using namespace std;
+
+const size_t KEYWORD_TABLE_HEADER_BYTES = 72;
+
+void appendLittleEndian(string& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out.push_back((char)((value >> (8 * i)) & 0xFF));
+    }
+}
+
+uint64_t loadLittleEndian(const char* data, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= (uint64_t)(unsigned char)data[i] << (8 * i);
+    }
+    return value;
+}
+
+uint64_t keywordTableChecksum(const char* data, size_t length) {
+    return fnv1a64(string_view(data, length));
+}
+
+bool writeKeywordTableFile(const string& path, const vector<string_view>& keywords,
+                           const vector<int>& freqs, const vector<double>& novelties) {
+    uint64_t n = keywords.size();
+    uint64_t offsetsPos = KEYWORD_TABLE_HEADER_BYTES;
+    uint64_t freqsPos = offsetsPos + 4 * (n + 1);
+    uint64_t noveltiesPos = (freqsPos + 4 * n + 7) / 8 * 8;
+    uint64_t heapPos = noveltiesPos + 8 * n;
+    uint64_t heapBytes = 0;
+    for (string_view keyword : keywords) heapBytes += keyword.length();
+    if (heapBytes > 0xFFFFFFFFull) {
+        return false;  // 偏移列是32位的
+    }
+
+    string body;  // 文件头之后的全部内容
+    body.reserve(heapPos + heapBytes - KEYWORD_TABLE_HEADER_BYTES);
+    uint64_t offset = 0;
+    for (string_view keyword : keywords) {
+        appendLittleEndian(body, offset, 4);
+        offset += keyword.length();
+    }
+    appendLittleEndian(body, offset, 4);
+    for (int freq : freqs) {
+        appendLittleEndian(body, (uint32_t)freq, 4);
+    }
+    body.resize(noveltiesPos - KEYWORD_TABLE_HEADER_BYTES, '\0');
+    for (double novelty : novelties) {
+        uint64_t bits;
+        memcpy(&bits, &novelty, sizeof(bits));
+        appendLittleEndian(body, bits, 8);
+    }
+    for (string_view keyword : keywords) {
+        body.append(keyword.data(), keyword.length());
+    }
+
+    string header(KEYWORD_TABLE_MAGIC, 4);
+    appendLittleEndian(header, KEYWORD_TABLE_VERSION, 4);
+    appendLittleEndian(header, 0, 8);
+    appendLittleEndian(header, n, 8);
+    appendLittleEndian(header, offsetsPos, 8);
+    appendLittleEndian(header, freqsPos, 8);
+    appendLittleEndian(header, noveltiesPos, 8);
+    appendLittleEndian(header, heapPos, 8);
+    appendLittleEndian(header, heapBytes, 8);
+    appendLittleEndian(header, keywordTableChecksum(body.data(), body.size()), 8);
+
+    ofstream out(path, ios::binary);
+    if (!out.is_open()) {
+        return false;
+    }
+    out.write(header.data(), header.size());
+    out.write(body.data(), body.size());
+    return (bool)out;
+}
+
+bool KeywordTableFile::open(const string& path, bool verifyChecksum) {
+    close();
+
+    // 各列按小端序直接当数组用，只支持小端序的机器
+    const uint16_t probe = 1;
+    if (*(const unsigned char*)&probe != 1 || !file.open(path)) {
+        return false;
+    }
+
+    string_view data = file.view();
+    if (data.length() < KEYWORD_TABLE_HEADER_BYTES || data.compare(0, 4, string_view(KEYWORD_TABLE_MAGIC, 4)) != 0 ||
+        loadLittleEndian(data.data() + 4, 4) != KEYWORD_TABLE_VERSION) {
+        close();
+        return false;
+    }
+    uint64_t n = loadLittleEndian(data.data() + 16, 8);
+    uint64_t offsetsPos = loadLittleEndian(data.data() + 24, 8);
+    uint64_t freqsPos = loadLittleEndian(data.data() + 32, 8);
+    uint64_t noveltiesPos = loadLittleEndian(data.data() + 40, 8);
+    uint64_t heapPos = loadLittleEndian(data.data() + 48, 8);
+    uint64_t heapBytes = loadLittleEndian(data.data() + 56, 8);
+    uint64_t checksum = loadLittleEndian(data.data() + 64, 8);
+
+    // 各列首尾相接、按宽度对齐且不越界。每个位置都先与文件大小比较再参与加法，表头里的任意值都不会在uint64中回绕：
+    // 每个关键词至少占16字节（偏移、频次、新颖度各一项），所以n有上界，之后的乘法和加法都不会溢出
+    uint64_t length = data.length();
+    bool layoutOk = n <= (length - KEYWORD_TABLE_HEADER_BYTES) / 16 && offsetsPos == KEYWORD_TABLE_HEADER_BYTES &&
+                    freqsPos == offsetsPos + 4 * (n + 1) && noveltiesPos <= length && noveltiesPos >= freqsPos + 4 * n &&
+                    noveltiesPos % 8 == 0 && heapPos <= length && heapPos == noveltiesPos + 8 * n &&
+                    heapBytes == length - heapPos;
+    if (!layoutOk || (verifyChecksum && keywordTableChecksum(data.data() + KEYWORD_TABLE_HEADER_BYTES,
+                                                             data.length() - KEYWORD_TABLE_HEADER_BYTES) != checksum)) {
+        close();
+        return false;
+    }
+
+    count = (size_t)n;
+    offsets = (const uint32_t*)(data.data() + offsetsPos);
+    freqs = (const int32_t*)(data.data() + freqsPos);
+    novelties = (const double*)(data.data() + noveltiesPos);
+    heap = data.data() + heapPos;
+
+    // 偏移不减且不超出字符串区（之后才能按偏移取关键词），关键词严格递增（BST可以据此直接建树）
+    bool ordered = offsets[0] == 0 && offsets[count] == heapBytes;
+    for (size_t i = 0; i < count && ordered; i++) {
+        ordered = offsets[i] <= offsets[i + 1] && offsets[i + 1] <= heapBytes && (i == 0 || keyword(i - 1) < keyword(i));
+    }
+    if (!ordered) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void KeywordTableFile::close() {
+    file.close();
+    count = 0;
+    offsets = nullptr;
+    freqs = nullptr;
+    novelties = nullptr;
+    heap = nullptr;
+}
+
+uint32_t KeywordDictionary::append(string_view keyword) {
+    uint32_t id = (uint32_t)size();
+    if (id > 0 && !(this->keyword(id - 1) < keyword)) {
+        return NO_KEYWORD_ID;  // 乱序或重复：追加后ID就不再保序
+    }
+    uint32_t hash = fnv1a32(keyword);
+    size_t slot = index.probe(keyword, hash, [this](uint32_t id) { return this->keyword(id); });
+    arena.append(keyword.data(), keyword.length());
+    offsets.push_back((uint32_t)arena.size());
+    index.fill(slot, hash, id, size());
+    return id;
+}
+
+void KeywordDictionary::clear() {
+    arena.clear();
+    offsets.assign(1, 0);
+    index.clear();
+}
+
+uint32_t KeywordDictionary::find(string_view keyword) const {
+    size_t slot = index.probe(keyword, fnv1a32(keyword), [this](uint32_t id) { return this->keyword(id); });
+    return index.occupied(slot) ? index.id(slot) : NO_KEYWORD_ID;
+}
+
+uint32_t KeywordDictionary::lowerBound(string_view keyword) const {
+    uint32_t lo = 0, hi = (uint32_t)size();
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (this->keyword(mid) < keyword) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
@@ -0,0 +1,87 @@
+#ifndef KEYWORD_TABLE_FILE_H
+#define KEYWORD_TABLE_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "mapped_file.h"
+#include "keyword_hash.h"
+
+// 二进制关键词统计表（.kwtb）：分析程序写出，BST和哈夫曼程序映射进内存后直接使用，启动时不需要解析文本。
+// 文件格式（整数均为小端序，各列按自身宽度对齐，可以直接当数组访问）：
+//   文件头72字节："KWTB" 版本号(u32) 保留(u64) 关键词数n(u64)
+//                 偏移列位置(u64) 频次列位置(u64) 新颖度列位置(u64) 字符串区位置(u64) 字符串区字节数(u64)
+//                 校验和(u64，文件头之后全部内容的64位FNV-1a)
+//   偏移列 u32 × (n+1)：第i个关键词是字符串区的 [offset[i], offset[i+1])
+//   频次列 i32 × n，新颖度列 f64 × n（按8字节对齐），最后是字符串区。
+// 关键词按字典序排列且互不相同，新颖度保存完整精度（文本CSV只有6位有效数字）。
+// 分析程序写出的统计表（文本CSV的数据行与.kwtb的各项顺序相同）同时就是保序关键词字典：第i个关键词的ID为i
+const char KEYWORD_TABLE_MAGIC[4] = {'K', 'W', 'T', 'B'};
+const uint32_t KEYWORD_TABLE_VERSION = 1;
+
+// 按扩展名判断是不是二进制统计表
+inline bool isKeywordTablePath(const std::string& path) {
+    return path.size() >= 5 && path.compare(path.size() - 5, 5, ".kwtb") == 0;
+}
+
+// 写出二进制统计表，keywords须按字典序排列且互不相同
+bool writeKeywordTableFile(const std::string& path, const std::vector<std::string_view>& keywords,
+                           const std::vector<int>& freqs, const std::vector<double>& novelties);
+
+// 只读打开的二进制统计表，各列直接指向映射的文件内容
+class KeywordTableFile {
+public:
+    // 映射并校验文件（格式、各列位置、关键词顺序；verifyChecksum为true时再核对校验和）
+    bool open(const std::string& path, bool verifyChecksum = true);
+    void close();
+
+    size_t size() const { return count; }
+    std::string_view keyword(size_t index) const {
+        return std::string_view(heap + offsets[index], offsets[index + 1] - offsets[index]);
+    }
+    int freq(size_t index) const { return freqs[index]; }
+    double avgNovelty(size_t index) const { return novelties[index]; }
+
+private:
+    MappedFile file;
+    size_t count = 0;
+    const uint32_t* offsets = nullptr;
+    const int32_t* freqs = nullptr;
+    const double* novelties = nullptr;
+    const char* heap = nullptr;
+};
+
+// 保序关键词字典：按字典序追加、互不相同的关键词，ID为追加的序号（0..n-1），ID的大小关系与关键词的字典序一致，
+// 比较两个字典中的关键词只需比较ID。关键词 -> ID 用与KeywordTable相同的KeywordHashIndex；
+// 字典外的关键词可以用lowerBound得到它在ID之间的位置
+const uint32_t NO_KEYWORD_ID = 0xFFFFFFFFu;
+
+class KeywordDictionary {
+public:
+    KeywordDictionary() : offsets(1, 0) {}
+
+    // 追加下一个关键词，返回它的ID；不大于上一个关键词时不追加，返回NO_KEYWORD_ID
+    uint32_t append(std::string_view keyword);
+    void clear();
+
+    size_t size() const { return offsets.size() - 1; }
+    std::string_view keyword(uint32_t id) const {
+        return std::string_view(arena.data() + offsets[id], offsets[id + 1] - offsets[id]);
+    }
+
+    // 关键词的ID，不在字典中时返回NO_KEYWORD_ID
+    uint32_t find(std::string_view keyword) const;
+    // 字典中小于keyword的关键词个数（二分查找；keyword在字典中时就是它的ID）
+    uint32_t lowerBound(std::string_view keyword) const;
+
+    size_t memoryBytes() const { return arena.capacity() + offsets.capacity() * sizeof(uint32_t) + index.memoryBytes(); }
+
+private:
+    std::string arena;
+    std::vector<uint32_t> offsets;  // 第id个关键词是arena的 [offsets[id], offsets[id+1])
+    KeywordHashIndex index;
+};
+
+#endif
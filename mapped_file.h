@@ -0,0 +1,101 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 只读内存映射文件：整个输入映射进地址空间，解析时直接切片，不逐行拷贝
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                 OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize)) {
+            close();
+            return false;
+        }
+        length = (size_t)fileSize.QuadPart;
+        if (length == 0) return true;  // 空文件无法映射，按空内容处理
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle == nullptr) {
+            close();
+            return false;
+        }
+        address = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (address == nullptr) {
+            close();
+            return false;
+        }
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close();
+            return false;
+        }
+        length = (size_t)st.st_size;
+        if (length == 0) return true;  // 空文件无法映射，按空内容处理
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close();
+            return false;
+        }
+        address = (const char*)p;
+        madvise(p, length, MADV_SEQUENTIAL);  // 顺序扫描，提示内核预读
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (address != nullptr) UnmapViewOfFile(address);
+        if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (address != nullptr) munmap((void*)address, length);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        address = nullptr;
+        length = 0;
+    }
+
+    std::string_view view() const { return std::string_view(address, length); }
+    size_t size() const { return length; }
+
+private:
+    const char* address = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+#endif
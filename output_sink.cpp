@@ -0,0 +1,113 @@
+#include "output_sink.h"
+#include <charconv>
+#include <cmath>
+using namespace std;
+
+bool parseRowFormat(const string& name, RowFormat& format) {
+    if (name == "text") {
+        format = RowFormat::TEXT;
+    } else if (name == "csv") {
+        format = RowFormat::CSV;
+    } else if (name == "jsonl") {
+        format = RowFormat::JSON_LINES;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+string_view rowFormatHeader(RowFormat format) {
+    return format == RowFormat::CSV ? "keyword,freq,avg_novelty\n" : "";
+}
+
+void appendInt(string& buffer, int value) {
+    char digits[16];
+    to_chars_result result = to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr - digits);
+}
+
+// precision为0时取能精确读回的最短形式，否则与 ostream 默认格式（%g）相同
+void appendDouble(string& buffer, double value, int precision) {
+    char digits[32];
+    to_chars_result result = precision > 0 ? to_chars(digits, digits + sizeof(digits), value, chars_format::general, precision)
+                                           : to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr - digits);
+}
+
+void appendCSVField(string& buffer, string_view field) {
+    if (field.find_first_of(",\"\r\n") == string_view::npos) {
+        buffer.append(field.data(), field.size());
+        return;
+    }
+    buffer.push_back('"');
+    for (char c : field) {
+        if (c == '"') buffer.push_back('"');
+        buffer.push_back(c);
+    }
+    buffer.push_back('"');
+}
+
+void appendJSONString(string& buffer, string_view str) {
+    static const char HEX[] = "0123456789abcdef";
+    buffer.push_back('"');
+    for (char c : str) {
+        unsigned char byte = (unsigned char)c;
+        if (c == '"' || c == '\\') {
+            buffer.push_back('\\');
+            buffer.push_back(c);
+        } else if (byte < 0x20) {
+            buffer.append("\\u00");
+            buffer.push_back(HEX[byte >> 4]);
+            buffer.push_back(HEX[byte & 0xF]);
+        } else {
+            buffer.push_back(c);
+        }
+    }
+    buffer.push_back('"');
+}
+
+void appendRow(string& buffer, RowFormat format, string_view keyword, int freq, double avg_novelty) {
+    switch (format) {
+    case RowFormat::TEXT:
+        buffer.append("Keyword: ");
+        buffer.append(keyword.data(), keyword.size());
+        buffer.append(", Freq: ");
+        appendInt(buffer, freq);
+        buffer.append(", Avg_Novelty: ");
+        appendDouble(buffer, avg_novelty, 6);
+        break;
+    case RowFormat::CSV:
+        appendCSVField(buffer, keyword);
+        buffer.push_back(',');
+        appendInt(buffer, freq);
+        buffer.push_back(',');
+        appendDouble(buffer, avg_novelty, 0);
+        break;
+    case RowFormat::JSON_LINES:
+        buffer.append("{\"keyword\":");
+        appendJSONString(buffer, keyword);
+        buffer.append(",\"freq\":");
+        appendInt(buffer, freq);
+        buffer.append(",\"avg_novelty\":");
+        if (isfinite(avg_novelty)) {
+            appendDouble(buffer, avg_novelty, 0);
+        } else {
+            buffer.append("null");  // JSON没有inf/nan
+        }
+        buffer.push_back('}');
+        break;
+    }
+    buffer.push_back('\n');
+}
+
+BufferedSink::BufferedSink(ostream& out, RowFormat format, size_t capacity) : out(out), format(format), capacity(capacity) {
+    buffer.reserve(capacity + 256);
+    append(rowFormatHeader(format));
+}
+
+void BufferedSink::flush() {
+    if (buffer.empty()) return;
+    out.write(buffer.data(), buffer.size());
+    written += buffer.size();
+    buffer.clear();
+}
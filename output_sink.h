@@ -0,0 +1,60 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <cstddef>
+
+// 结果输出层：逐行格式化到内存缓冲区，攒满后一次写出，不再每行 endl 刷新一次。
+// 整数和浮点数用 to_chars 格式化，不经过流的locale与格式状态
+
+// 行格式：
+//   TEXT        Keyword: k, Freq: f, Avg_Novelty: x（与原来的屏幕输出逐字节相同，新颖度保留6位有效数字）
+//   CSV         keyword,freq,avg_novelty（首行为表头，关键词含逗号或引号时加引号，新颖度按能精确读回的最短形式）
+//   JSON_LINES  {"keyword":"k","freq":f,"avg_novelty":x}（每行一个JSON对象）
+enum class RowFormat { TEXT, CSV, JSON_LINES };
+
+// "text" / "csv" / "jsonl"，无法识别时返回false
+bool parseRowFormat(const std::string& name, RowFormat& format);
+
+// 该格式的表头（只有CSV有），没有时为空
+std::string_view rowFormatHeader(RowFormat format);
+
+// 把一行追加到buffer末尾
+void appendRow(std::string& buffer, RowFormat format, std::string_view keyword, int freq, double avg_novelty);
+
+// 带缓冲区的行输出：缓冲区超过capacity时整块写到out，析构时写出剩余部分（不刷新out本身）
+class BufferedSink {
+public:
+    static const size_t DEFAULT_CAPACITY = 1 << 20;
+
+    BufferedSink(std::ostream& out, RowFormat format, size_t capacity = DEFAULT_CAPACITY);
+    ~BufferedSink() { flush(); }
+    BufferedSink(const BufferedSink&) = delete;
+    BufferedSink& operator=(const BufferedSink&) = delete;
+
+    void row(std::string_view keyword, int freq, double avg_novelty) {
+        appendRow(buffer, format, keyword, freq, avg_novelty);
+        if (buffer.size() >= capacity) flush();
+    }
+
+    // 原样追加一段已经格式化好的文本
+    void append(std::string_view text) {
+        buffer.append(text.data(), text.size());
+        if (buffer.size() >= capacity) flush();
+    }
+
+    void flush();
+    // 已写到out的字节数
+    size_t bytesWritten() const { return written; }
+
+private:
+    std::ostream& out;
+    RowFormat format;
+    size_t capacity;
+    std::string buffer;
+    size_t written = 0;
+};
+
+#endif
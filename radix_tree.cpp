@@ -0,0 +1,531 @@
+#include "radix_tree.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <queue>
+using namespace std;
+
+// 节点缩小的阈值比扩大的略低，避免在边界上反复插删时来回转换
+const int NODE16_SHRINK = 3;
+const int NODE48_SHRINK = 12;
+const int NODE256_SHRINK = 37;
+
+void RadixKeywordTree::clear() {
+    root = nullptr;
+    leafCount = 0;
+    leaves.clear();
+    nodes4.clear();
+    nodes16.clear();
+    nodes48.clear();
+    nodes256.clear();
+    keywords.clear();
+}
+
+void RadixKeywordTree::load(const vector<KeywordRow>& rows) {
+    clear();
+    for (const KeywordRow& row : rows) {
+        insert(row.keyword, row.freq, row.avg_novelty);
+    }
+}
+
+RadixInner* RadixKeywordTree::newInner(NodeType type, string_view prefix) {
+    RadixInner* node;
+    switch (type) {
+    case NODE4: node = nodes4.allocate(); break;
+    case NODE16: node = nodes16.allocate(); break;
+    case NODE48: node = nodes48.allocate(); break;
+    default: node = nodes256.allocate(); break;
+    }
+    node->type = type;
+    node->count = 0;
+    node->maxFreq = INT_MIN;
+    node->prefix = prefix;
+    node->value = nullptr;
+    return node;
+}
+
+RadixLeaf* RadixKeywordTree::newLeaf(string_view keyword, int freq, double avg_novelty) {
+    RadixLeaf* leaf = leaves.allocate();
+    leaf->type = LEAF;
+    leaf->freq = freq;
+    leaf->keyword = keyword;
+    leaf->avg_novelty = avg_novelty;
+    leafCount++;
+    return leaf;
+}
+
+void RadixKeywordTree::freeNode(RadixNode* node) {
+    switch (node->type) {
+    case LEAF: leaves.release(static_cast<RadixLeaf*>(node)); break;
+    case NODE4: nodes4.release(static_cast<RadixNode4*>(node)); break;
+    case NODE16: nodes16.release(static_cast<RadixNode16*>(node)); break;
+    case NODE48: nodes48.release(static_cast<RadixNode48*>(node)); break;
+    default: nodes256.release(static_cast<RadixNode256*>(node)); break;
+    }
+}
+
+RadixNode* const* RadixKeywordTree::findChild(const RadixInner* node, uint8_t byte) {
+    switch (node->type) {
+    case NODE4: {
+        const RadixNode4* n = static_cast<const RadixNode4*>(node);
+        for (int i = 0; i < n->count; i++) {
+            if (n->keys[i] == byte) return &n->children[i];
+        }
+        return nullptr;
+    }
+    case NODE16: {
+        const RadixNode16* n = static_cast<const RadixNode16*>(node);
+        for (int i = 0; i < n->count; i++) {
+            if (n->keys[i] == byte) return &n->children[i];
+        }
+        return nullptr;
+    }
+    case NODE48: {
+        const RadixNode48* n = static_cast<const RadixNode48*>(node);
+        return n->index[byte] != 0 ? &n->children[n->index[byte] - 1] : nullptr;
+    }
+    default: {
+        const RadixNode256* n = static_cast<const RadixNode256*>(node);
+        return n->children[byte] != nullptr ? &n->children[byte] : nullptr;
+    }
+    }
+}
+
+// 换成另一种布局时保留公共部分
+static void copyHeader(RadixInner* to, const RadixInner* from) {
+    to->count = from->count;
+    to->maxFreq = from->maxFreq;
+    to->prefix = from->prefix;
+    to->value = from->value;
+}
+
+// 在有序的keys/children中插入一项
+static void insertSorted(uint8_t* keys, RadixNode** children, int count, uint8_t byte, RadixNode* child) {
+    int pos = count;
+    while (pos > 0 && keys[pos - 1] > byte) {
+        keys[pos] = keys[pos - 1];
+        children[pos] = children[pos - 1];
+        pos--;
+    }
+    keys[pos] = byte;
+    children[pos] = child;
+}
+
+// 添加孩子，节点满了就换成更大的布局（slot指向新节点）
+void RadixKeywordTree::addChild(RadixNode*& slot, uint8_t byte, RadixNode* child) {
+    RadixInner* node = static_cast<RadixInner*>(slot);
+    switch (node->type) {
+    case NODE4: {
+        RadixNode4* n = static_cast<RadixNode4*>(node);
+        if (n->count < 4) {
+            insertSorted(n->keys, n->children, n->count++, byte, child);
+            return;
+        }
+        RadixNode16* grown = static_cast<RadixNode16*>(newInner(NODE16, n->prefix));
+        copyHeader(grown, n);
+        copy(n->keys, n->keys + 4, grown->keys);
+        copy(n->children, n->children + 4, grown->children);
+        freeNode(n);
+        slot = grown;
+        break;
+    }
+    case NODE16: {
+        RadixNode16* n = static_cast<RadixNode16*>(node);
+        if (n->count < 16) {
+            insertSorted(n->keys, n->children, n->count++, byte, child);
+            return;
+        }
+        RadixNode48* grown = static_cast<RadixNode48*>(newInner(NODE48, n->prefix));
+        copyHeader(grown, n);
+        for (int i = 0; i < 16; i++) {
+            grown->index[n->keys[i]] = (uint8_t)(i + 1);
+            grown->children[i] = n->children[i];
+        }
+        freeNode(n);
+        slot = grown;
+        break;
+    }
+    case NODE48: {
+        RadixNode48* n = static_cast<RadixNode48*>(node);
+        if (n->count < 48) {
+            n->children[n->count] = child;  // children的前count项始终是满的
+            n->index[byte] = (uint8_t)++n->count;
+            return;
+        }
+        RadixNode256* grown = static_cast<RadixNode256*>(newInner(NODE256, n->prefix));
+        copyHeader(grown, n);
+        for (int b = 0; b < 256; b++) {
+            if (n->index[b] != 0) grown->children[b] = n->children[n->index[b] - 1];
+        }
+        freeNode(n);
+        slot = grown;
+        break;
+    }
+    default: {
+        RadixNode256* n = static_cast<RadixNode256*>(node);
+        n->children[byte] = child;
+        n->count++;
+        return;
+    }
+    }
+    addChild(slot, byte, child);
+}
+
+// 移除孩子，孩子太少时换成更小的布局（slot指向新节点）
+void RadixKeywordTree::removeChild(RadixNode*& slot, uint8_t byte) {
+    RadixInner* node = static_cast<RadixInner*>(slot);
+    switch (node->type) {
+    case NODE4:
+    case NODE16: {
+        uint8_t* keys = node->type == NODE4 ? static_cast<RadixNode4*>(node)->keys : static_cast<RadixNode16*>(node)->keys;
+        RadixNode** children = node->type == NODE4 ? static_cast<RadixNode4*>(node)->children
+                                                   : static_cast<RadixNode16*>(node)->children;
+        int pos = 0;
+        while (keys[pos] != byte) pos++;
+        for (int i = pos + 1; i < node->count; i++) {
+            keys[i - 1] = keys[i];
+            children[i - 1] = children[i];
+        }
+        node->count--;
+        if (node->type == NODE16 && node->count <= NODE16_SHRINK) {
+            RadixNode4* shrunk = static_cast<RadixNode4*>(newInner(NODE4, node->prefix));
+            copyHeader(shrunk, node);
+            copy(keys, keys + node->count, shrunk->keys);
+            copy(children, children + node->count, shrunk->children);
+            freeNode(node);
+            slot = shrunk;
+        }
+        break;
+    }
+    case NODE48: {
+        RadixNode48* n = static_cast<RadixNode48*>(node);
+        int pos = n->index[byte] - 1;
+        int last = n->count - 1;
+        n->index[byte] = 0;
+        if (pos != last) {  // 把最后一项挪进空位，保持前count项是满的
+            n->children[pos] = n->children[last];
+            for (int b = 0; b < 256; b++) {
+                if (n->index[b] == last + 1) {
+                    n->index[b] = (uint8_t)(pos + 1);
+                    break;
+                }
+            }
+        }
+        n->children[last] = nullptr;
+        n->count--;
+        if (n->count <= NODE48_SHRINK) {
+            RadixNode16* shrunk = static_cast<RadixNode16*>(newInner(NODE16, n->prefix));
+            copyHeader(shrunk, n);
+            int i = 0;
+            for (int b = 0; b < 256; b++) {
+                if (n->index[b] != 0) {
+                    shrunk->keys[i] = (uint8_t)b;
+                    shrunk->children[i++] = n->children[n->index[b] - 1];
+                }
+            }
+            freeNode(n);
+            slot = shrunk;
+        }
+        break;
+    }
+    default: {
+        RadixNode256* n = static_cast<RadixNode256*>(node);
+        n->children[byte] = nullptr;
+        n->count--;
+        if (n->count <= NODE256_SHRINK) {
+            RadixNode48* shrunk = static_cast<RadixNode48*>(newInner(NODE48, n->prefix));
+            copyHeader(shrunk, n);
+            int i = 0;
+            for (int b = 0; b < 256; b++) {
+                if (n->children[b] != nullptr) {
+                    shrunk->children[i] = n->children[b];
+                    shrunk->index[b] = (uint8_t)++i;
+                }
+            }
+            freeNode(n);
+            slot = shrunk;
+        }
+        break;
+    }
+    }
+}
+
+void RadixKeywordTree::recomputeMaxFreq(RadixInner* node) {
+    int maxFreq = node->value != nullptr ? node->value->freq : INT_MIN;
+    forEachChild(node, [&maxFreq](uint8_t, const RadixNode* child) { maxFreq = max(maxFreq, nodeMaxFreq(child)); });
+    node->maxFreq = maxFreq;
+}
+
+// 子树中字典序最小的关键词
+const RadixLeaf* RadixKeywordTree::leftmostLeaf(const RadixNode* node) {
+    while (node->type != LEAF) {
+        const RadixInner* inner = static_cast<const RadixInner*>(node);
+        if (inner->value != nullptr) return inner->value;
+        const RadixNode* first = nullptr;
+        forEachChild(inner, [&first](uint8_t, const RadixNode* child) {
+            if (first == nullptr) first = child;
+        });
+        node = first;
+    }
+    return static_cast<const RadixLeaf*>(node);
+}
+
+void RadixKeywordTree::insert(string_view keyword, int freq, double avg_novelty) {
+    insertAt(root, 0, keyword, freq, avg_novelty);
+}
+
+// slot所指子树的关键词都与keyword共享前depth个字节
+void RadixKeywordTree::insertAt(RadixNode*& slot, size_t depth, string_view keyword, int freq, double avg_novelty) {
+    if (slot == nullptr) {
+        slot = newLeaf(keywords.store(keyword), freq, avg_novelty);
+        return;
+    }
+
+    if (slot->type == LEAF) {
+        RadixLeaf* leaf = static_cast<RadixLeaf*>(slot);
+        if (leaf->keyword == keyword) {  // 相等则更新
+            leaf->freq = freq;
+            leaf->avg_novelty = avg_novelty;
+            return;
+        }
+        // 两个关键词从depth起的公共部分成为新节点的前缀，在第一个不同的字节处分开
+        RadixLeaf* added = newLeaf(keywords.store(keyword), freq, avg_novelty);
+        size_t split = depth;
+        size_t limit = min(leaf->keyword.length(), keyword.length());
+        while (split < limit && leaf->keyword[split] == keyword[split]) split++;
+        RadixNode* node = newInner(NODE4, added->keyword.substr(depth, split - depth));
+        for (RadixLeaf* child : {leaf, added}) {
+            if (child->keyword.length() == split) {
+                static_cast<RadixInner*>(node)->value = child;
+            } else {
+                addChild(node, (uint8_t)child->keyword[split], child);
+            }
+        }
+        static_cast<RadixInner*>(node)->maxFreq = max(leaf->freq, freq);
+        slot = node;
+        return;
+    }
+
+    RadixInner* node = static_cast<RadixInner*>(slot);
+    string_view rest = keyword.substr(depth);
+    size_t matched = 0;
+    size_t limit = min(node->prefix.length(), rest.length());
+    while (matched < limit && node->prefix[matched] == rest[matched]) matched++;
+
+    if (matched < node->prefix.length()) {
+        // 在前缀中间分开：新节点取走前缀的公共部分，原节点留下分叉字节之后的部分
+        RadixNode* parent = newInner(NODE4, node->prefix.substr(0, matched));
+        uint8_t byte = (uint8_t)node->prefix[matched];
+        node->prefix = node->prefix.substr(matched + 1);
+        addChild(parent, byte, node);
+        RadixLeaf* added = newLeaf(keywords.store(keyword), freq, avg_novelty);
+        if (rest.length() == matched) {
+            static_cast<RadixInner*>(parent)->value = added;
+        } else {
+            addChild(parent, (uint8_t)rest[matched], added);
+        }
+        static_cast<RadixInner*>(parent)->maxFreq = max(node->maxFreq, freq);
+        slot = parent;
+        return;
+    }
+
+    depth += matched;
+    if (depth == keyword.length()) {
+        if (node->value == nullptr) {
+            node->value = newLeaf(keywords.store(keyword), freq, avg_novelty);
+            node->maxFreq = max(node->maxFreq, freq);
+            return;
+        }
+        int before = node->value->freq;
+        node->value->freq = freq;
+        node->value->avg_novelty = avg_novelty;
+        if (freq >= node->maxFreq) {
+            node->maxFreq = freq;
+        } else if (before == node->maxFreq) {
+            recomputeMaxFreq(node);
+        }
+        return;
+    }
+
+    RadixNode* const* child = findChild(node, (uint8_t)keyword[depth]);
+    if (child == nullptr) {
+        addChild(slot, (uint8_t)keyword[depth], newLeaf(keywords.store(keyword), freq, avg_novelty));
+        node = static_cast<RadixInner*>(slot);
+        node->maxFreq = max(node->maxFreq, freq);
+        return;
+    }
+    RadixNode*& childSlot = *const_cast<RadixNode**>(child);
+    int before = nodeMaxFreq(childSlot);
+    insertAt(childSlot, depth + 1, keyword, freq, avg_novelty);
+    int after = nodeMaxFreq(childSlot);
+    if (after >= node->maxFreq) {
+        node->maxFreq = after;
+    } else if (before == node->maxFreq) {
+        recomputeMaxFreq(node);  // 原来的最大值被调低了
+    }
+}
+
+bool RadixKeywordTree::erase(string_view keyword) {
+    return eraseAt(root, 0, keyword);
+}
+
+bool RadixKeywordTree::eraseAt(RadixNode*& slot, size_t depth, string_view keyword) {
+    if (slot == nullptr) {
+        return false;
+    }
+
+    if (slot->type == LEAF) {
+        if (static_cast<RadixLeaf*>(slot)->keyword != keyword) return false;
+        freeNode(slot);
+        slot = nullptr;
+        leafCount--;
+        return true;
+    }
+
+    RadixInner* node = static_cast<RadixInner*>(slot);
+    size_t nodeDepth = depth;
+    if (keyword.length() - depth < node->prefix.length() ||
+        keyword.compare(depth, node->prefix.length(), node->prefix) != 0) {
+        return false;
+    }
+    depth += node->prefix.length();
+
+    int removedMax;
+    if (depth == keyword.length()) {
+        if (node->value == nullptr) return false;
+        removedMax = node->value->freq;
+        freeNode(node->value);
+        node->value = nullptr;
+        leafCount--;
+    } else {
+        RadixNode* const* child = findChild(node, (uint8_t)keyword[depth]);
+        if (child == nullptr) return false;
+        RadixNode*& childSlot = *const_cast<RadixNode**>(child);
+        removedMax = nodeMaxFreq(childSlot);
+        if (!eraseAt(childSlot, depth + 1, keyword)) return false;
+        if (childSlot == nullptr) {
+            removeChild(slot, (uint8_t)keyword[depth]);
+            node = static_cast<RadixInner*>(slot);
+        }
+    }
+
+    if (removedMax == node->maxFreq) {
+        recomputeMaxFreq(node);
+    }
+    collapse(slot, nodeDepth);
+    return true;
+}
+
+// 删除后节点只剩一个关键词或一个孩子时，把它并入下一层，保持路径压缩
+void RadixKeywordTree::collapse(RadixNode*& slot, size_t depth) {
+    RadixInner* node = static_cast<RadixInner*>(slot);
+    if (node->count == 0) {
+        slot = node->value;
+        freeNode(node);
+        return;
+    }
+    if (node->count > 1 || node->value != nullptr) {
+        return;
+    }
+
+    RadixNode* child = nullptr;
+    forEachChild(node, [&child](uint8_t, RadixNode* only) { child = only; });
+    if (child->type != LEAF) {
+        // 本节点的前缀 + 分叉字节 + 孩子的前缀，正好是子树中任一关键词从depth起的一段
+        RadixInner* inner = static_cast<RadixInner*>(child);
+        size_t length = node->prefix.length() + 1 + inner->prefix.length();
+        inner->prefix = leftmostLeaf(inner)->keyword.substr(depth, length);
+    }
+    slot = child;
+    freeNode(node);
+}
+
+const RadixLeaf* RadixKeywordTree::search(string_view keyword) const {
+    const RadixNode* node = root;
+    size_t depth = 0;
+    while (node != nullptr) {
+        if (node->type == LEAF) {
+            // 前depth个字节在路径上已经比较过
+            const RadixLeaf* leaf = static_cast<const RadixLeaf*>(node);
+            bool equal = leaf->keyword.length() == keyword.length() &&
+                         memcmp(leaf->keyword.data() + depth, keyword.data() + depth, keyword.length() - depth) == 0;
+            return equal ? leaf : nullptr;
+        }
+        const RadixInner* inner = static_cast<const RadixInner*>(node);
+        size_t prefixLength = inner->prefix.length();
+        if (keyword.length() - depth < prefixLength ||
+            memcmp(inner->prefix.data(), keyword.data() + depth, prefixLength) != 0) {
+            return nullptr;
+        }
+        depth += prefixLength;
+        if (depth == keyword.length()) {
+            return inner->value;
+        }
+        RadixNode* const* child = findChild(inner, (uint8_t)keyword[depth]);
+        node = child != nullptr ? *child : nullptr;
+        depth++;
+    }
+    return nullptr;
+}
+
+const RadixNode* RadixKeywordTree::descendToPrefix(string_view prefix) const {
+    const RadixNode* node = root;
+    size_t depth = 0;
+    while (node != nullptr) {
+        if (node->type == LEAF) {
+            string_view keyword = static_cast<const RadixLeaf*>(node)->keyword;
+            return keyword.substr(0, prefix.length()) == prefix ? node : nullptr;
+        }
+        const RadixInner* inner = static_cast<const RadixInner*>(node);
+        string_view rest = prefix.substr(depth);
+        size_t overlap = min(inner->prefix.length(), rest.length());
+        if (inner->prefix.compare(0, overlap, rest.substr(0, overlap)) != 0) {
+            return nullptr;
+        }
+        if (rest.length() <= inner->prefix.length()) {
+            return node;  // prefix在这个节点内用完，整棵子树都匹配
+        }
+        depth += inner->prefix.length();
+        RadixNode* const* child = findChild(inner, (uint8_t)prefix[depth]);
+        node = child != nullptr ? *child : nullptr;
+        depth++;
+    }
+    return nullptr;
+}
+
+vector<const RadixLeaf*> RadixKeywordTree::topByFreq(string_view prefix, size_t k) const {
+    // 最佳优先：队列里是互不相交的子树（或单个关键词），按子树最大freq出队；
+    // 同频时按子树中最小的关键词出队，子树对应一段连续的字典序区间，因此同频的关键词也按字典序输出
+    struct Candidate {
+        int freq;
+        string_view firstKeyword;
+        const RadixNode* node;
+        bool operator<(const Candidate& other) const {
+            if (freq != other.freq) return freq < other.freq;
+            return firstKeyword > other.firstKeyword;
+        }
+    };
+
+    vector<const RadixLeaf*> result;
+    const RadixNode* start = descendToPrefix(prefix);
+    if (start == nullptr || k == 0) return result;
+
+    priority_queue<Candidate> queue;
+    queue.push({nodeMaxFreq(start), leftmostLeaf(start)->keyword, start});
+    while (!queue.empty() && result.size() < k) {
+        Candidate top = queue.top();
+        queue.pop();
+        if (top.node->type == LEAF) {
+            result.push_back(static_cast<const RadixLeaf*>(top.node));
+            continue;
+        }
+        const RadixInner* inner = static_cast<const RadixInner*>(top.node);
+        if (inner->value != nullptr) {
+            queue.push({inner->value->freq, inner->value->keyword, inner->value});
+        }
+        forEachChild(inner, [&queue](uint8_t, const RadixNode* child) {
+            queue.push({nodeMaxFreq(child), leftmostLeaf(child)->keyword, child});
+        });
+    }
+    return result;
+}
@@ -0,0 +1,214 @@
+#ifndef RADIX_TREE_H
+#define RADIX_TREE_H
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include "keyword_bst.h"
+
+// 关键词自适应基数树（ART）：与BST提供相同的 关键词 -> (freq, avg_novelty) 操作，另外支持前缀查询（自动补全）。
+// 内部节点按孩子数在4/16/48/256四种布局之间切换，单孩子链压缩成节点上的前缀；
+// 查找时关键词的每个字节只比较一次，公共前缀（"recogniz..."、"method..."）不会在每一层重复比较。
+// 每个内部节点记录子树中的最大freq，按频率取前K个时可以先走频率高的子树并提前结束。
+// 关键词字节放在只追加的字符串区里（节点前缀也是其中的切片），删除的关键词直到clear才回收
+
+struct RadixNode {
+    uint8_t type;
+};
+
+// 叶子：一个完整的关键词及其统计值
+struct RadixLeaf : RadixNode {
+    int freq;  // 放在type后面的空隙里，叶子正好32字节
+    std::string_view keyword;
+    double avg_novelty;
+};
+
+struct RadixInner : RadixNode {
+    uint16_t count;          // 孩子数
+    int maxFreq;             // 子树（含value）中最大的freq
+    std::string_view prefix; // 压缩掉的公共前缀
+    RadixLeaf* value;        // 恰好在这里结束的关键词（它是子树中其他关键词的前缀）
+};
+
+struct RadixNode4 : RadixInner {
+    uint8_t keys[4];  // 有序
+    RadixNode* children[4];
+};
+
+struct RadixNode16 : RadixInner {
+    uint8_t keys[16];  // 有序
+    RadixNode* children[16];
+};
+
+struct RadixNode48 : RadixInner {
+    uint8_t index[256];  // 字节 -> children下标+1，0表示没有
+    RadixNode* children[48];
+};
+
+struct RadixNode256 : RadixInner {
+    RadixNode* children[256];
+};
+
+// 某一种节点的池：按块申请，释放的节点挂到空闲链表上复用，整棵树一次性释放
+template <class Node>
+class RadixNodePool {
+public:
+    ~RadixNodePool() { clear(); }
+
+    Node* allocate() {
+        void* memory;
+        if (freeList != nullptr) {
+            memory = freeList;
+            freeList = *static_cast<void**>(freeList);
+        } else {
+            if (blocks.empty() || used == BLOCK_NODES) {
+                blocks.push_back(static_cast<Node*>(::operator new(sizeof(Node) * BLOCK_NODES)));
+                used = 0;
+            }
+            memory = blocks.back() + used++;
+        }
+        return new (memory) Node();
+    }
+
+    void release(Node* node) {
+        *reinterpret_cast<void**>(node) = freeList;
+        freeList = node;
+    }
+
+    void clear() {
+        for (Node* block : blocks) {
+            ::operator delete(block);
+        }
+        blocks.clear();
+        used = 0;
+        freeList = nullptr;
+    }
+
+    size_t bytesReserved() const { return blocks.size() * BLOCK_NODES * sizeof(Node); }
+
+private:
+    // 每块约64KB
+    static constexpr size_t BLOCK_NODES = sizeof(Node) < 65536 ? 65536 / sizeof(Node) : 1;
+    std::vector<Node*> blocks;
+    size_t used = 0;
+    void* freeList = nullptr;
+};
+
+class RadixKeywordTree {
+public:
+    enum NodeType : uint8_t { LEAF, NODE4, NODE16, NODE48, NODE256 };
+
+    RadixKeywordTree() = default;
+    RadixKeywordTree(const RadixKeywordTree&) = delete;
+    RadixKeywordTree& operator=(const RadixKeywordTree&) = delete;
+
+    // 插入或更新（关键词已存在时更新频率与新颖度）
+    void insert(std::string_view keyword, int freq, double avg_novelty);
+    const RadixLeaf* search(std::string_view keyword) const;
+    // 删除关键词，不存在时返回false
+    bool erase(std::string_view keyword);
+    void clear();
+    // 用关键词统计表整体替换树的内容（重复的关键词保留最后一行，与bulkLoad一致）
+    void load(const std::vector<KeywordRow>& rows);
+
+    size_t size() const { return leafCount; }
+    // 各节点池与字符串区占用的字节数
+    size_t memoryBytes() const {
+        return leaves.bytesReserved() + nodes4.bytesReserved() + nodes16.bytesReserved() + nodes48.bytesReserved() +
+               nodes256.bytesReserved() + keywords.bytesReserved();
+    }
+
+    // 按字典序对每个以prefix开头的关键词调用visit，返回个数
+    template <class Visit>
+    size_t forEachWithPrefix(std::string_view prefix, Visit visit) const {
+        const RadixNode* node = descendToPrefix(prefix);
+        size_t count = 0;
+        if (node != nullptr) visitInOrder(node, visit, count);
+        return count;
+    }
+
+    // 以prefix开头、freq最高的k个关键词（freq降序，同频按字典序）
+    std::vector<const RadixLeaf*> topByFreq(std::string_view prefix, size_t k) const;
+
+private:
+    static int nodeMaxFreq(const RadixNode* node) {
+        return node->type == LEAF ? static_cast<const RadixLeaf*>(node)->freq : static_cast<const RadixInner*>(node)->maxFreq;
+    }
+
+    // 按字节顺序对每个孩子调用f(byte, child)
+    template <class F>
+    static void forEachChild(const RadixInner* node, F f) {
+        switch (node->type) {
+        case NODE4: {
+            const RadixNode4* n = static_cast<const RadixNode4*>(node);
+            for (int i = 0; i < n->count; i++) f(n->keys[i], n->children[i]);
+            break;
+        }
+        case NODE16: {
+            const RadixNode16* n = static_cast<const RadixNode16*>(node);
+            for (int i = 0; i < n->count; i++) f(n->keys[i], n->children[i]);
+            break;
+        }
+        case NODE48: {
+            const RadixNode48* n = static_cast<const RadixNode48*>(node);
+            for (int b = 0; b < 256; b++) {
+                if (n->index[b] != 0) f((uint8_t)b, n->children[n->index[b] - 1]);
+            }
+            break;
+        }
+        default: {
+            const RadixNode256* n = static_cast<const RadixNode256*>(node);
+            for (int b = 0; b < 256; b++) {
+                if (n->children[b] != nullptr) f((uint8_t)b, n->children[b]);
+            }
+            break;
+        }
+        }
+    }
+
+    // 中序：先是在本节点结束的关键词（更短），再按字节顺序访问孩子
+    template <class Visit>
+    static void visitInOrder(const RadixNode* node, Visit& visit, size_t& count) {
+        if (node->type == LEAF) {
+            visit(*static_cast<const RadixLeaf*>(node));
+            count++;
+            return;
+        }
+        const RadixInner* inner = static_cast<const RadixInner*>(node);
+        if (inner->value != nullptr) {
+            visit(*inner->value);
+            count++;
+        }
+        forEachChild(inner, [&](uint8_t, const RadixNode* child) { visitInOrder(child, visit, count); });
+    }
+
+    // 找到全部关键词都以prefix开头的最高子树，没有时返回nullptr
+    const RadixNode* descendToPrefix(std::string_view prefix) const;
+
+    static RadixNode* const* findChild(const RadixInner* node, uint8_t byte);
+    RadixInner* newInner(NodeType type, std::string_view prefix);
+    RadixLeaf* newLeaf(std::string_view keyword, int freq, double avg_novelty);
+    void freeNode(RadixNode* node);
+
+    void addChild(RadixNode*& slot, uint8_t byte, RadixNode* child);
+    void removeChild(RadixNode*& slot, uint8_t byte);
+    static void recomputeMaxFreq(RadixInner* node);
+    static const RadixLeaf* leftmostLeaf(const RadixNode* node);
+
+    void insertAt(RadixNode*& slot, size_t depth, std::string_view keyword, int freq, double avg_novelty);
+    bool eraseAt(RadixNode*& slot, size_t depth, std::string_view keyword);
+    void collapse(RadixNode*& slot, size_t depth);
+
+    RadixNode* root = nullptr;
+    size_t leafCount = 0;
+    RadixNodePool<RadixLeaf> leaves;
+    RadixNodePool<RadixNode4> nodes4;
+    RadixNodePool<RadixNode16> nodes16;
+    RadixNodePool<RadixNode48> nodes48;
+    RadixNodePool<RadixNode256> nodes256;
+    StringArena keywords;
+};
+
+#endif
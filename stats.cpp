@@ -0,0 +1,94 @@
+#include "stats.h"
+#include <iostream>
+#include <fstream>
+#include <map>
+using namespace std;
+
+// 按名字排序输出；map的元素地址在插入后不变，可以把引用交给统计点长期持有
+map<string, uint64_t>& counterTable() {
+    static map<string, uint64_t> table;
+    return table;
+}
+
+map<string, TimerStat>& timerTable() {
+    static map<string, TimerStat> table;
+    return table;
+}
+
+map<string, vector<uint64_t>>& histogramTable() {
+    static map<string, vector<uint64_t>> table;
+    return table;
+}
+
+uint64_t& statsCounter(const char* name) {
+    return counterTable()[name];
+}
+
+TimerStat& statsTimer(const char* name) {
+    return timerTable()[name];
+}
+
+void statsHistogram(const char* name, const vector<uint64_t>& counts) {
+    histogramTable()[name] = counts;
+}
+
+// 统计项的名字都是代码里的字面量，只需转义引号和反斜杠
+void writeJSONString(ostream& out, const string& str) {
+    out << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+void writeStatsJSON(ostream& out) {
+#ifdef ENABLE_STATS
+    out << "{\n  \"enabled\": true,\n  \"counters\": {";
+#else
+    out << "{\n  \"enabled\": false,\n  \"counters\": {";
+#endif
+    const char* separator = "\n    ";
+    for (const auto& entry : counterTable()) {
+        out << separator;
+        writeJSONString(out, entry.first);
+        out << ": " << entry.second;
+        separator = ",\n    ";
+    }
+
+    out << "\n  },\n  \"timers\": {";
+    separator = "\n    ";
+    for (const auto& entry : timerTable()) {
+        out << separator;
+        writeJSONString(out, entry.first);
+        out << ": {\"calls\": " << entry.second.calls << ", \"ms\": " << entry.second.nanoseconds / 1e6 << "}";
+        separator = ",\n    ";
+    }
+
+    out << "\n  },\n  \"histograms\": {";
+    separator = "\n    ";
+    for (const auto& entry : histogramTable()) {
+        out << separator;
+        writeJSONString(out, entry.first);
+        out << ": [";
+        for (size_t i = 0; i < entry.second.size(); i++) {
+            out << (i > 0 ? ", " : "") << entry.second[i];
+        }
+        out << "]";
+        separator = ",\n    ";
+    }
+    out << "\n  }\n}" << endl;
+}
+
+bool writeStatsJSON(const string& path) {
+    if (path == "-") {
+        writeStatsJSON(cout);
+        return true;
+    }
+    ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+    writeStatsJSON(out);
+    return (bool)out;
+}
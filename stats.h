@@ -0,0 +1,70 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <chrono>
+#include <cstdint>
+
+// 运行统计：热点路径上的计数器与分阶段计时器，程序结束时用 --stats 输出成JSON。
+// 每个统计点第一次执行时按名字登记一次，之后只是对一个全局变量做加法；计时器只放在整段的阶段上，不放在单次查找里。
+// 配置时 -DENABLE_STATS=OFF 则 STATS_COUNT / STATS_TIMER 展开为空，统计代码整个编译掉。
+// 登记与计数都不加锁，只在单线程的路径上使用
+
+// 一个计时器的累计值
+struct TimerStat {
+    uint64_t calls = 0;
+    uint64_t nanoseconds = 0;
+};
+
+// 按名字取得计数器、计时器（第一次取时登记，返回的引用一直有效）
+uint64_t& statsCounter(const char* name);
+TimerStat& statsTimer(const char* name);
+// 记录一个直方图（下标为取值，如节点深度），同名的会被覆盖
+void statsHistogram(const char* name, const std::vector<uint64_t>& counts);
+
+// 输出所有统计项：{"enabled":..,"counters":{..},"timers":{"名字":{"calls":..,"ms":..}},"histograms":{"名字":[..]}}
+void writeStatsJSON(std::ostream& out);
+// 写到文件，path为"-"时写到标准输出
+bool writeStatsJSON(const std::string& path);
+
+// 作用域计时：析构时把经过的时间累加到计时器上
+class ScopedTimer {
+public:
+    explicit ScopedTimer(TimerStat& timer) : timer(timer), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        timer.calls++;
+        timer.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    TimerStat& timer;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define STATS_CONCAT_IMPL(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_IMPL(a, b)
+
+#ifdef ENABLE_STATS
+// 计数器name加上n
+#define STATS_COUNT(name, n)                                  \
+    do {                                                      \
+        static uint64_t& statsCounterRef = statsCounter(name); \
+        statsCounterRef += (n);                               \
+    } while (0)
+// 从这里到所在作用域结束的时间计入计时器name
+#define STATS_TIMER(name)                                                              \
+    static TimerStat& STATS_CONCAT(statsTimerRef, __LINE__) = statsTimer(name);        \
+    ScopedTimer STATS_CONCAT(statsScope, __LINE__)(STATS_CONCAT(statsTimerRef, __LINE__))
+#else
+#define STATS_COUNT(name, n) \
+    do {                     \
+        (void)sizeof(n);     \
+    } while (0)
+#define STATS_TIMER(name)
+#endif
+
+#endif
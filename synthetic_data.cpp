@@ -0,0 +1,95 @@
+#include "synthetic_data.h"
+#include <algorithm>
+#include <unordered_set>
+#include <cmath>
+#include <cstdio>
+using namespace std;
+
+ZipfSampler::ZipfSampler(size_t n, double exponent) : cumulative(n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        sum += 1.0 / pow((double)(i + 1), exponent);
+        cumulative[i] = sum;
+    }
+}
+
+uint32_t ZipfSampler::sample(SyntheticRandom& rng) const {
+    double target = rng.unit() * cumulative.back();
+    size_t index = upper_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin();
+    return (uint32_t)min(index, cumulative.size() - 1);
+}
+
+vector<string> generateVocabulary(size_t vocabularySize, uint32_t seed) {
+    static const char* const SYLLABLES[] = {
+        "re", "cog", "niz", "ing", "meth", "od", "voice", "sig", "nal", "pro", "cess", "data",
+        "net", "work", "opt", "ic", "al", "sem", "i", "con", "duct", "or", "lu", "mi",
+        "trans", "port", "vec", "tor", "lay", "er", "graph", "ene",
+    };
+    const uint32_t syllableCount = sizeof(SYLLABLES) / sizeof(SYLLABLES[0]);
+
+    SyntheticRandom rng(seed);
+    auto makeWord = [&](int minSyllables, int maxSyllables) {
+        string word;
+        for (int i = rng.between(minSyllables, maxSyllables); i > 0; i--) {
+            word += SYLLABLES[rng.below(syllableCount)];
+        }
+        return word;
+    };
+
+    vector<string> vocabulary;
+    vocabulary.reserve(vocabularySize);
+    unordered_set<string> seen;
+    int maxSyllables = 4;
+    size_t collisions = 0;
+    while (vocabulary.size() < vocabularySize) {
+        string word = makeWord(2, maxSyllables);
+        if (rng.below(10) < 3) {
+            word += ' ';
+            word += makeWord(2, 3);
+        }
+        if (seen.insert(word).second) {
+            vocabulary.push_back(word);
+        } else if (++collisions > vocabulary.size() / 4 + 1000) {
+            maxSyllables++;  // 词表较大时放宽音节数，避免反复撞车
+            collisions = 0;
+        }
+    }
+    return vocabulary;
+}
+
+string generatePatentCSV(size_t rowCount, size_t vocabularySize, uint32_t seed) {
+    vector<string> vocabulary = generateVocabulary(vocabularySize, seed);
+    ZipfSampler zipf(vocabulary.size(), 1.0);
+    SyntheticRandom rng(seed + 1);
+
+    string csv = "PatentID,Title,Abstract,Year,Assignee,Country,CPC,Keywords,Novelty\n";
+    csv.reserve(rowCount * 280);
+    vector<uint32_t> picked;
+    char number[64];
+    for (size_t row = 0; row < rowCount; row++) {
+        picked.clear();
+        for (int i = rng.between(3, 10); i > 0; i--) {
+            picked.push_back(zipf.sample(rng));
+        }
+        const string& first = vocabulary[picked.front()];
+        const string& last = vocabulary[picked.back()];
+
+        snprintf(number, sizeof(number), "US%07zu,", row);
+        csv += number;
+        csv += "\"Method, apparatus and system for " + first + "\",";
+        csv += "\"An " + first + " is disclosed, comprising " + last + ", wherein the " +
+               vocabulary[rng.below((uint32_t)vocabulary.size())] + " operates.\",";
+        snprintf(number, sizeof(number), "%d,Company %zu,US,G06F,", 1979 + (int)(row % 3), row % 500);
+        csv += number;
+        csv += '[';
+        for (size_t i = 0; i < picked.size(); i++) {
+            if (i > 0) csv += ", ";
+            csv += '"';
+            csv += vocabulary[picked[i]];
+            csv += '"';
+        }
+        snprintf(number, sizeof(number), "],%.4f\n", rng.uniform(0.0, 20.0));
+        csv += number;
+    }
+    return csv;
+}
@@ -0,0 +1,49 @@
+#ifndef SYNTHETIC_DATA_H
+#define SYNTHETIC_DATA_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+
+// 确定性的合成数据：与DeepPatentAI同样形状的专利CSV和关键词统计表，供性能测试使用。
+// 只用mt19937的原始输出（标准规定了其序列）自行换算区间，不用标准库的分布类，
+// 所以同一种子在不同编译器/标准库上生成的数据逐字节相同
+
+// 合成数据的随机源
+class SyntheticRandom {
+public:
+    explicit SyntheticRandom(uint32_t seed) : engine(seed) {}
+
+    // [0, n)
+    uint32_t below(uint32_t n) { return (uint32_t)(((uint64_t)engine() * n) >> 32); }
+    // [lo, hi]
+    int between(int lo, int hi) { return lo + (int)below((uint32_t)(hi - lo + 1)); }
+    // [0, 1)
+    double unit() { return (engine() >> 5) * (1.0 / 134217728.0); }
+    // [lo, hi)
+    double uniform(double lo, double hi) { return lo + (hi - lo) * unit(); }
+
+private:
+    std::mt19937 engine;
+};
+
+// 按Zipf分布（第k个词的概率正比于 1/(k+1)^exponent）抽取词表下标
+class ZipfSampler {
+public:
+    ZipfSampler(size_t n, double exponent);
+    uint32_t sample(SyntheticRandom& rng) const;
+
+private:
+    std::vector<double> cumulative;
+};
+
+// 生成vocabularySize个互不相同的关键词（音节拼成的单词，约三成是两个词的短语），顺序即Zipf排名
+std::vector<std::string> generateVocabulary(size_t vocabularySize, uint32_t seed);
+
+// 生成专利CSV全文（含表头）：PatentID,Title,Abstract,Year,Assignee,Country,CPC,Keywords,Novelty。
+// Title、Abstract带引号且含逗号；Keywords形如 ["kw1", "kw2"]，关键词按Zipf分布抽取；Novelty为[0, 20)的小数
+std::string generatePatentCSV(size_t rowCount, size_t vocabularySize, uint32_t seed = 20240601);
+
+#endif
@@ -0,0 +1,254 @@
+#include "versioned_bst.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+using namespace std;
+
+// 每块申请的节点数
+const size_t VERSION_BLOCK_NODES = 4096;
+
+VersionedKeywordTree::VersionedKeywordTree() {}
+
+VersionedKeywordTree::~VersionedKeywordTree() {
+    // 没有读线程了，所有节点（当前版本的和待回收的）随块一起释放
+    for (VersionNode* block : blocks) {
+        ::operator delete(block);
+    }
+}
+
+VersionedKeywordTree::Reader::Reader(VersionedKeywordTree& tree) : tree(tree), slot(MAX_READERS) {
+    for (size_t i = 0; i < MAX_READERS; i++) {
+        bool expected = false;
+        if (tree.slots[i].claimed.compare_exchange_strong(expected, true)) {
+            slot = i;
+            return;
+        }
+    }
+    throw runtime_error("同时读取的线程超过 " + to_string(MAX_READERS) + " 个");
+}
+
+VersionedKeywordTree::Reader::~Reader() {
+    tree.slots[slot].epoch.store(0);
+    tree.slots[slot].claimed.store(false);
+}
+
+const VersionNode* VersionedKeywordTree::Reader::pin() {
+    // 先公布自己所在的纪元，再读根（两者都是seq_cst）：写线程要么看到这个纪元而暂缓回收，
+    // 要么在公布之前就已扫描完，此时读到的一定是摘下那些节点之后发布的根
+    tree.slots[slot].epoch.store(tree.globalEpoch.load());
+    return tree.root.load();
+}
+
+void VersionedKeywordTree::Reader::unpin() {
+    tree.slots[slot].epoch.store(0, memory_order_release);
+}
+
+bool VersionedKeywordTree::Reader::search(string_view keyword, SnapshotEntry& result) {
+    const VersionNode* node = VersionedKeywordTree::search(pin(), keyword);
+    if (node != nullptr) {
+        result = {node->keyword, node->freq, node->avg_novelty};
+    }
+    unpin();
+    return node != nullptr;
+}
+
+const VersionNode* VersionedKeywordTree::search(const VersionNode* node, string_view keyword) {
+    while (node != nullptr) {
+        int cmp = keyword.compare(node->keyword);
+        if (cmp == 0) break;
+        node = cmp < 0 ? node->left : node->right;
+    }
+    return node;
+}
+
+size_t VersionedKeywordTree::pendingReclaim() const {
+    lock_guard<mutex> lock(writeLock);
+    return retired.size();
+}
+
+VersionNode* VersionedKeywordTree::allocate(string_view keyword, int freq, double avg_novelty,
+                                            const VersionNode* left, const VersionNode* right) {
+    VersionNode* node;
+    if (freeList != nullptr) {
+        node = freeList;
+        freeList = (VersionNode*)freeList->right;
+    } else {
+        if (blocks.empty() || blockUsed == VERSION_BLOCK_NODES) {
+            blocks.push_back(static_cast<VersionNode*>(::operator new(sizeof(VersionNode) * VERSION_BLOCK_NODES)));
+            blockUsed = 0;
+        }
+        node = blocks.back() + blockUsed++;
+    }
+    int height = 1 + max(left ? left->height : 0, right ? right->height : 0);
+    return new (node) VersionNode{keyword, freq, height, avg_novelty, left, right};
+}
+
+// 新建一个节点：关键词和统计值取自source，孩子为left、right
+const VersionNode* VersionedKeywordTree::makeNode(const VersionNode* left, const VersionNode* source, const VersionNode* right) {
+    return allocate(source->keyword, source->freq, source->avg_novelty, left, right);
+}
+
+// 由left、source、right组成平衡的子树（两侧高度差不超过2）。旋转时拆开的孩子换成新节点，旧的摘下
+const VersionNode* VersionedKeywordTree::balance(const VersionNode* left, const VersionNode* source, const VersionNode* right) {
+    int hl = left ? left->height : 0;
+    int hr = right ? right->height : 0;
+    if (hl > hr + 1) {
+        const VersionNode* ll = left->left;
+        const VersionNode* lr = left->right;
+        retire(left);
+        if ((ll ? ll->height : 0) >= (lr ? lr->height : 0)) {  // LL型：右旋
+            return makeNode(ll, left, makeNode(lr, source, right));
+        }
+        retire(lr);  // LR型：左右双旋
+        return makeNode(makeNode(ll, left, lr->left), lr, makeNode(lr->right, source, right));
+    }
+    if (hr > hl + 1) {
+        const VersionNode* rl = right->left;
+        const VersionNode* rr = right->right;
+        retire(right);
+        if ((rr ? rr->height : 0) >= (rl ? rl->height : 0)) {  // RR型：左旋
+            return makeNode(makeNode(left, source, rl), right, rr);
+        }
+        retire(rl);  // RL型：右左双旋
+        return makeNode(makeNode(left, source, rl->left), rl, makeNode(rl->right, right, rr));
+    }
+    return makeNode(left, source, right);
+}
+
+// 摘下的节点记上当前纪元，等读线程都离开这个纪元后再复用。
+// 本次更新中新建、尚未发布的节点也走这里，只是晚一点复用
+void VersionedKeywordTree::retire(const VersionNode* node) {
+    retired.push_back({const_cast<VersionNode*>(node), globalEpoch.load(memory_order_relaxed)});
+}
+
+const VersionNode* VersionedKeywordTree::insertAt(const VersionNode* node, string_view keyword, int freq, double avg_novelty) {
+    if (node == nullptr) {
+        return allocate(keywords.store(keyword), freq, avg_novelty, nullptr, nullptr);
+    }
+
+    int cmp = keyword.compare(node->keyword);
+    retire(node);
+    if (cmp < 0) {
+        return balance(insertAt(node->left, keyword, freq, avg_novelty), node, node->right);
+    } else if (cmp > 0) {
+        return balance(node->left, node, insertAt(node->right, keyword, freq, avg_novelty));
+    }
+    // 相等则更新
+    return allocate(node->keyword, freq, avg_novelty, node->left, node->right);
+}
+
+// 摘下子树中的最小节点（由minNode带回），返回新的子树根
+const VersionNode* VersionedKeywordTree::removeMinAt(const VersionNode* node, const VersionNode*& minNode) {
+    retire(node);
+    if (node->left == nullptr) {
+        minNode = node;
+        return node->right;
+    }
+    const VersionNode* left = removeMinAt(node->left, minNode);
+    return balance(left, node, node->right);
+}
+
+const VersionNode* VersionedKeywordTree::eraseAt(const VersionNode* node, string_view keyword, bool& erased) {
+    if (node == nullptr) {
+        return nullptr;
+    }
+
+    int cmp = keyword.compare(node->keyword);
+    if (cmp < 0) {
+        const VersionNode* left = eraseAt(node->left, keyword, erased);
+        if (!erased) return node;  // 没找到，路径保持原样
+        retire(node);
+        return balance(left, node, node->right);
+    } else if (cmp > 0) {
+        const VersionNode* right = eraseAt(node->right, keyword, erased);
+        if (!erased) return node;
+        retire(node);
+        return balance(node->left, node, right);
+    }
+
+    erased = true;
+    retire(node);
+    if (node->left == nullptr) return node->right;
+    if (node->right == nullptr) return node->left;
+    // 有两个子树：用中序后继顶替
+    const VersionNode* successor;
+    const VersionNode* right = removeMinAt(node->right, successor);
+    return balance(node->left, successor, right);
+}
+
+const VersionNode* VersionedKeywordTree::buildBalanced(const vector<const KeywordRow*>& rows, size_t lo, size_t hi) {
+    if (lo >= hi) return nullptr;
+
+    size_t mid = lo + (hi - lo) / 2;
+    const VersionNode* left = buildBalanced(rows, lo, mid);
+    const VersionNode* right = buildBalanced(rows, mid + 1, hi);
+    return allocate(keywords.store(rows[mid]->keyword), rows[mid]->freq, rows[mid]->avg_novelty, left, right);
+}
+
+// 发布新的根，推进全局纪元，然后回收已经没有读线程能访问到的节点
+void VersionedKeywordTree::publish(const VersionNode* newRoot) {
+    root.store(newRoot);
+    versionCount.fetch_add(1, memory_order_relaxed);
+    globalEpoch.fetch_add(1);
+    reclaim();
+}
+
+void VersionedKeywordTree::reclaim() {
+    if (retired.empty()) return;
+
+    // 正在读的线程中最早的纪元；纪元早于它时摘下的节点已经不可能被访问
+    uint64_t oldest = globalEpoch.load();
+    for (const ReaderSlot& slot : slots) {
+        uint64_t epoch = slot.epoch.load();
+        if (epoch != 0 && epoch < oldest) oldest = epoch;
+    }
+
+    size_t kept = 0;
+    for (const RetiredNode& entry : retired) {
+        if (entry.epoch < oldest) {
+            entry.node->right = freeList;
+            freeList = entry.node;
+        } else {
+            retired[kept++] = entry;
+        }
+    }
+    retired.resize(kept);
+}
+
+void VersionedKeywordTree::insert(string_view keyword, int freq, double avg_novelty) {
+    lock_guard<mutex> lock(writeLock);
+    publish(insertAt(root.load(memory_order_relaxed), keyword, freq, avg_novelty));
+}
+
+bool VersionedKeywordTree::erase(string_view keyword) {
+    lock_guard<mutex> lock(writeLock);
+    bool erased = false;
+    const VersionNode* newRoot = eraseAt(root.load(memory_order_relaxed), keyword, erased);
+    if (erased) publish(newRoot);
+    return erased;
+}
+
+void VersionedKeywordTree::load(const vector<KeywordRow>& rows) {
+    vector<const KeywordRow*> sorted;
+    sorted.reserve(rows.size());
+    for (const KeywordRow& row : rows) {
+        sorted.push_back(&row);
+    }
+    stable_sort(sorted.begin(), sorted.end(), [](const KeywordRow* a, const KeywordRow* b) {
+        return a->keyword < b->keyword;
+    });
+    // 相同关键词只保留最后一行
+    size_t kept = 0;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        if (kept > 0 && sorted[kept - 1]->keyword == sorted[i]->keyword) {
+            sorted[kept - 1] = sorted[i];
+        } else {
+            sorted[kept++] = sorted[i];
+        }
+    }
+    sorted.resize(kept);
+
+    lock_guard<mutex> lock(writeLock);
+    forEach(root.load(memory_order_relaxed), [this](const VersionNode* node) { retire(node); });
+    publish(buildBalanced(sorted, 0, sorted.size()));
+}
@@ -0,0 +1,129 @@
+#ifndef VERSIONED_BST_H
+#define VERSIONED_BST_H
+
+#include <string_view>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include "keyword_bst.h"
+
+// 多版本关键词树：每次更新只复制从根到修改点的路径（其余子树与旧版本共享），再原子地发布新的根。
+// 读线程取得某个版本后无锁遍历，期间写线程可以继续发布新版本；被替换下来的旧节点按纪元（epoch）回收：
+// 节点在纪元e被摘下，等所有正在读的线程都进入e之后的纪元才真正复用。
+// 路径复制的代价与树高成正比，所以这里始终按AVL保持平衡，与 USE_AVL_TREE 无关。
+// 写操作之间用互斥锁串行；关键词字节放在只追加的字符串区里，删除的关键词直到整棵树释放才回收
+
+// 版本树的节点，发布后不再修改
+struct VersionNode {
+    std::string_view keyword;
+    int freq;
+    int height;
+    double avg_novelty;
+    const VersionNode *left, *right;
+};
+
+class VersionedKeywordTree {
+public:
+    // 同时存在的Reader个数上限（每个Reader占一个纪元槽位，写线程回收时扫描全部槽位）
+    static const size_t MAX_READERS = 64;
+
+    VersionedKeywordTree();
+    ~VersionedKeywordTree();  // 调用时不能再有读线程
+    VersionedKeywordTree(const VersionedKeywordTree&) = delete;
+    VersionedKeywordTree& operator=(const VersionedKeywordTree&) = delete;
+
+    // 读线程的句柄：每个读线程创建一个（占用一个纪元槽位），pin/unpin之间可以无锁遍历pin返回的版本
+    class Reader {
+    public:
+        // 已有MAX_READERS个Reader时抛出std::runtime_error，等其他Reader析构释放槽位后可以再创建
+        explicit Reader(VersionedKeywordTree& tree);
+        ~Reader();
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        // 进入读临界区，返回当前版本的根；unpin之前该版本的节点都不会被回收
+        const VersionNode* pin();
+        void unpin();
+
+        // pin + 查找 + unpin，找到时把结果复制到result
+        bool search(std::string_view keyword, SnapshotEntry& result);
+
+    private:
+        VersionedKeywordTree& tree;
+        size_t slot;
+    };
+
+    // 插入或更新（关键词已存在时更新频率与新颖度），发布新版本
+    void insert(std::string_view keyword, int freq, double avg_novelty);
+    // 删除关键词，不存在时返回false且不发布新版本
+    bool erase(std::string_view keyword);
+    // 用关键词统计表整体替换树的内容（重复的关键词保留最后一行，与bulkLoad一致）
+    void load(const std::vector<KeywordRow>& rows);
+
+    // 已发布的版本数
+    uint64_t version() const { return versionCount.load(std::memory_order_relaxed); }
+    // 已摘下但还在等待读线程离开的节点数
+    size_t pendingReclaim() const;
+
+    // 在某个版本中查找
+    static const VersionNode* search(const VersionNode* root, std::string_view keyword);
+
+    // 按关键词字典序遍历某个版本
+    template <class Visit>
+    static void forEach(const VersionNode* root, Visit visit) {
+        std::vector<const VersionNode*> stack;
+        for (const VersionNode* node = root; node != nullptr || !stack.empty();) {
+            while (node != nullptr) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            visit(node);
+            node = node->right;
+        }
+    }
+
+private:
+    // 读线程的纪元槽位，独占一条缓存行；epoch为0表示不在读临界区
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{0};
+        std::atomic<bool> claimed{false};
+    };
+
+    struct RetiredNode {
+        VersionNode* node;
+        uint64_t epoch;  // 摘下时的全局纪元
+    };
+
+    VersionNode* allocate(std::string_view keyword, int freq, double avg_novelty,
+                          const VersionNode* left, const VersionNode* right);
+    const VersionNode* makeNode(const VersionNode* left, const VersionNode* source, const VersionNode* right);
+    const VersionNode* balance(const VersionNode* left, const VersionNode* source, const VersionNode* right);
+    void retire(const VersionNode* node);
+
+    const VersionNode* insertAt(const VersionNode* node, std::string_view keyword, int freq, double avg_novelty);
+    const VersionNode* eraseAt(const VersionNode* node, std::string_view keyword, bool& erased);
+    const VersionNode* removeMinAt(const VersionNode* node, const VersionNode*& minNode);
+    const VersionNode* buildBalanced(const std::vector<const KeywordRow*>& rows, size_t lo, size_t hi);
+
+    void publish(const VersionNode* newRoot);
+    void reclaim();
+
+    std::atomic<const VersionNode*> root{nullptr};
+    std::atomic<uint64_t> globalEpoch{1};
+    std::atomic<uint64_t> versionCount{0};
+    ReaderSlot slots[MAX_READERS];
+
+    // 以下只由持有writeLock的写线程访问
+    mutable std::mutex writeLock;
+    std::vector<RetiredNode> retired;
+    std::vector<VersionNode*> blocks;  // 节点按块申请，回收的节点挂到空闲链表上复用
+    size_t blockUsed = 0;
+    VersionNode* freeList = nullptr;
+    StringArena keywords;
+};
+
+#endif